@@ -26,10 +26,9 @@
 // 0 -> only obtain the energy distribution of ChR information (to check exotic refractive indices)
   #if 1
   #define boostEfficiency
-// 1 -> to enable boostEfficiency - tempering with photon emission angles so they would not fly all around, but
-//      towards the detector. If changing the geometry, one will also have a warning flag to prevent a possible error
+// 1 -> to enable boostEfficiency - forced emission of Cherenkov models, i.e., photons are emitted (with weights) only
+//      towards the detector. Their cones are found from the geometry, so the geometry can be changed by UI commands
 // 0 -> no boosting efficiency - the phi angle of emitted Cherenkov photons is in the range [0, 2*pi)
-  constexpr bool g_throwErrorForNonDefault = true;
     #if 0
     #define followMinMaxValues
     inline double g_maxPhiValue = -DBL_MAX;
@@ -18,6 +18,9 @@ and prepare output files (.csv as well) for obtaining graphs in N dimensions. Th
 value is used as a dependent, while N dimensions are independent. Also, according to G4AnalysisManager
 only four data types can be accepted - int, double, float, and std::string. Note, even though it's just
 a counter class, in a few lines of code that can change (see the NOTE "countVector").
+If tracks have weights (e.g., weighted thinning of Cherenkov photons), one should
+use SetWeightColumn<*weight column ID*>() before Process_N_D_Data, so the weights are
+summed instead of counting the rows.
 One should run this class after acquiring all data and closing G4AnalysisManager NTuple files. Thus,
 as only the Master thread can run this class, the ideal place to run this class would be EndOfRunAction,
 but for the master thread:
@@ -144,6 +147,14 @@ public:
 	template <size_t... tupleSortingOrder_N_Dimensions>
 	void Process_N_D_Data(const std::vector<double>& vectorOfBinValues, const char* outFileName, const char* efficiencyFile = "");
 
+	/*
+	With a weight column, Process_N_D_Data sums the weights of the rows in each bin instead of counting them. The column
+	must be numeric. Without the weight column (the default), every row counts as 1.
+	*/
+	template <size_t WeightColumn>
+	inline void SetWeightColumn();
+	[[nodiscard]] inline double GetSumOfWeights() const;
+
 protected:
 	//Initial check of used template parameters in Process_N_D_Data
 	template <size_t... RestDim>
@@ -159,6 +170,7 @@ protected:
 	G4fs::path m_currentPath;
 	G4fs::path m_newDIRPath;
 	std::mutex m_workerThreadMutex;
+	double (*p_weightOfRow)(const tuple_t&) = nullptr; // nullptr - each row counts as 1
 	unsigned int m_verboseLevel;
 	bool m_efficiencyFlag;
 
@@ -171,9 +183,9 @@ protected:
 	template <size_t NextDim, size_t... RestDim>
 	void SortDataVecForCounting(std::vector<std::vector<double>>&, const iterator_t begin, const iterator_t end);
 	template <size_t NextDim, size_t... RestDim>
-	void CountFinalData(const std::vector<std::vector<double>>&, std::vector<size_t>&, iterator_t, iterator_t, const size_t);
+	void CountFinalData(const std::vector<std::vector<double>>&, std::vector<double>&, iterator_t, iterator_t, const size_t);
 	template <size_t NextDim, size_t... RestDim>
-	void PrintOutputData(const std::vector<std::vector<double>>&, std::vector<size_t>&, std::ofstream&, const size_t multiplier, std::string&, std::ostringstream&);
+	void PrintOutputData(const std::vector<std::vector<double>>&, std::vector<double>&, std::ofstream&, const size_t multiplier, std::string&, std::ostringstream&);
 private:
 	void WorkersToLoadCsvFiles(std::string_view fileName, std::string_view ntupleName);
 	template <typename T, typename... SubArgs>
@@ -241,6 +253,10 @@ template <size_t I, typename... Args>
 	return std::get<I>(first) < second;
 }
 template <size_t I, typename... Args>
+[[nodiscard]] inline double GetSpecificTupleValueAsDouble(const std::tuple<Args...>& aTuple) {
+	return static_cast<double>(std::get<I>(aTuple));
+}
+template <size_t I, typename... Args>
 [[nodiscard]] inline bool GreaterCompareSpecificTupleWithADoubleValue(const std::tuple<Args...>& first, const double second) {
 	return std::get<I>(first) > second;;
 }
@@ -344,6 +360,38 @@ void ProcessCsvData<Args...>::LoadNewData(std::string_view fileName, std::string
 
 
 
+#if _HAS_CXX20
+template<typename... Args>
+	requires G4AnslysisTypes<Args...>
+#else
+template <typename... Args>
+#endif // _HAS_CXX20
+template <size_t WeightColumn>
+void ProcessCsvData<Args...>::SetWeightColumn() {
+	static_assert(!std::is_same_v<std::tuple_element_t<WeightColumn, tuple_t>, std::string>,
+		"The weight column of a ProcessCsvData object must be numeric (int, double or float)!\n");
+	p_weightOfRow = &GetSpecificTupleValueAsDouble<WeightColumn, Args...>;
+}
+
+
+
+#if _HAS_CXX20
+template<typename... Args>
+	requires G4AnslysisTypes<Args...>
+#else
+template <typename... Args>
+#endif // _HAS_CXX20
+double ProcessCsvData<Args...>::GetSumOfWeights() const {
+	if (!p_weightOfRow)
+		return static_cast<double>(m_dataVec.size());
+	double sumOfWeights = 0.;
+	for (const tuple_t& aRow : m_dataVec)
+		sumOfWeights += p_weightOfRow(aRow);
+	return sumOfWeights;
+}
+
+
+
 #if _HAS_CXX20
 template<typename... Args>
 	requires G4AnslysisTypes<Args...>
@@ -476,12 +524,12 @@ AlreadyLoadedEfficiency:
 		strStreamHelper << std::fixed << std::setprecision(2) << binWidth;
 		outFileName += "_Bin_" + strStreamHelper.str() + ".csv";
 		/*
-		NOTE "countVector": for now I'm using std::vector<size_t> because I'm currently keep this class
-		as a counter class. However, I might change the size_t type in the future and then this
-		class can easily change the entire point... Thus, placing a struct 'DataStruct' instead
-		of size_t gives whatever data are needed without any problems.
+		NOTE "countVector": for now I'm using std::vector<double> because the class counts rows or,
+		with a weight column, sums their weights. However, I might change the type in the future
+		and then this class can easily change the entire point... Thus, placing a struct 'DataStruct'
+		instead of double gives whatever data are needed without any problems.
 		*/
-		std::vector<size_t> countVector;
+		std::vector<double> countVector;
 		/*
 		binVectors are helper vectors. Each dimension has two associated helperVectors.
 		The former one holds the printing value, i.e., the middle of the bin, while
@@ -507,7 +555,7 @@ AlreadyLoadedEfficiency:
 		}
 		countVector.reserve(countNo + 1);
 		for (size_t i = 0; i < countNo; i++)
-			countVector.emplace_back(0);
+			countVector.emplace_back(0.);
 		SortDataVecForCounting<Dimensions...>(binVectors, m_dataVec.begin(), m_dataVec.end());
 		CountFinalData<Dimensions...>(binVectors, countVector, m_dataVec.begin(), m_dataVec.end(), 0ll);
 		m_newDIRPath /= outFileName;
@@ -641,7 +689,7 @@ template <typename... Args>
 #endif // _HAS_CXX20
 template <size_t NextDim, size_t... RestDim>
 void ProcessCsvData<Args...>::CountFinalData(const std::vector<std::vector<double>>& binVectors,
-	std::vector<size_t>& countVector, iterator_t begin, iterator_t end, const size_t multiplier) {
+	std::vector<double>& countVector, iterator_t begin, iterator_t end, const size_t multiplier) {
 	/*
 	only the last sorted dimension is used for counting here. On the other hand, multiplier passes the information
 	from higher-order dimensions that helps to find the exact index where to change the counter.
@@ -652,7 +700,8 @@ void ProcessCsvData<Args...>::CountFinalData(const std::vector<std::vector<doubl
 		for (; begin != end; begin++) {
 			while (true) {
 				if (LessCompareSpecificTupleWithADoubleValue<NextDim, Args...>(*begin, binVectors.back()[toAdd])) {
-					countVector[multiplier * binVectors[binVectors.size() - 2 * (sizeof...(RestDim) + 1)].size() + toAdd - 1]++;
+					countVector[multiplier * binVectors[binVectors.size() - 2 * (sizeof...(RestDim) + 1)].size() + toAdd - 1] +=
+						p_weightOfRow ? p_weightOfRow(*begin) : 1.;
 					break;
 				}
 				else {
@@ -688,7 +737,7 @@ template<typename... Args>
 template <typename... Args>
 #endif // _HAS_CXX20
 template <size_t NextDim, size_t... RestDim>
-void ProcessCsvData<Args...>::PrintOutputData(const std::vector<std::vector<double>>& binVectors, std::vector<size_t>& countVector, std::ofstream& outFile, const size_t multiplier, std::string& stringHelper, std::ostringstream& strStreamHelper) {
+void ProcessCsvData<Args...>::PrintOutputData(const std::vector<std::vector<double>>& binVectors, std::vector<double>& countVector, std::ofstream& outFile, const size_t multiplier, std::string& stringHelper, std::ostringstream& strStreamHelper) {
 	/*
 	The same logic as before, i.e., divide and use multiplier.
 	The efficiency is included here. Still, might improve the efficiency system in the future
@@ -697,22 +746,25 @@ void ProcessCsvData<Args...>::PrintOutputData(const std::vector<std::vector<doub
 		if constexpr (sizeof...(RestDim) == 0) {
 			size_t coef = multiplier * (binVectors.end() - 2)->size() + i;
 			if (!m_efficiencyFlag) {
-				if (countVector[coef] != 0) {
-					if (stringHelper.empty())
-						outFile << (*(binVectors.end() - 2))[i] << ',' << countVector[coef] << '\n';
-					else
-						outFile << stringHelper << ',' << (*(binVectors.end() - 2))[i] << ',' << countVector[coef] << '\n';
+				if (countVector[coef] != 0.) {
+					if (!stringHelper.empty())
+						outFile << stringHelper << ',';
+					outFile << (*(binVectors.end() - 2))[i] << ',';
+					if (p_weightOfRow)
+						outFile << countVector[coef] << '\n';
+					else //counts are printed as integers
+						outFile << static_cast<size_t>(countVector[coef]) << '\n';
 				}
 			}
 			else {
 				//stringHelper is always empty in this case because this works only for sizeof...(Dimensions) == 1
-				if (countVector[coef] != 0) {
+				if (countVector[coef] != 0.) {
 					try {
 						//The following should work with some reasonable bin values and efficiency tables
 						auto itr1 = std::lower_bound(m_efficiencyValues.begin(), m_efficiencyValues.end(), binVectors[0][i],
 							[](std::pair<double, double> aPair, double value) {return aPair.first < value; });
 						double efficiency = G4LinearInterpolate2D_GetY((itr1 - 1)->second, itr1->second, (itr1 - 1)->first, itr1->first, binVectors[0][i]);
-						outFile << binVectors[0][i] << ',' << efficiency * (double)countVector[coef] << '\n';
+						outFile << binVectors[0][i] << ',' << efficiency * countVector[coef] << '\n';
 					}
 					catch (...) {
 						G4Exception("ProcessCsvData<Args...>::PrintOutputData", "FE_ProcCsvData03", FatalException,
@@ -10,7 +10,6 @@
 #include "ProcessCsvData.hpp"
 #include "G4CherenkovProcess.hh"
 #include "G4StandardCherenkovProcess.hh"
-#include "G4ThinTargetChR_Model.hh"
 
 #define RunA_PrintReadMeTrueOrFalse(someBoolValue)	\
 	if (someBoolValue)								\
@@ -48,16 +47,47 @@ static void Task_SteppingActionData(std::ofstream& outFS) {
 #endif // standardRun
 
 #ifdef boostEfficiency
-static void Task_StackingActionData(std::ofstream& outFS) {
-	outFS << std::setw(16) << "Delta phi:" << g_stackingAction->GetDeltaPhi() << " deg\n"
-		<< std::setw(16) << "Theta min:" << g_stackingAction->GetThetaMin() / deg << " deg\n"
-		<< std::setw(16) << "Theta max:" << g_stackingAction->GetThetaMax() / deg << " deg\n";
+// forced emission (and angular biasing) is set for models of worker threads
+static void Task_ForcedEmissionData(std::ofstream& outFS) {
+	const G4CherenkovProcess* chProc = dynamic_cast<const G4CherenkovProcess*>(G4ProcessTable::GetProcessTable()->FindProcess("Cherenkov", "e-"));
+	if (!chProc) {
+		outFS << "Not used (G4CherenkovProcess not found)\n";
+		return;
+	}
+	for (size_t i = 0; i < chProc->GetNumberOfRegisteredModels(); i++) {
+		const G4BaseChR_Model* aModel = chProc->GetChRModel(i);
+		const G4ChRForcedEmission* theForcedEmission = aModel->GetForcedEmission();
+		const G4ChRAngularBiasing* theBiasing = aModel->GetAngularBiasing();
+		std::string modelID = "Model ID: " + std::to_string(i);
+		outFS << std::setw(18) << modelID << "-> ";
+		if (!theForcedEmission && !theBiasing) {
+			outFS << "Not used\n";
+			continue;
+		}
+		if (theForcedEmission) {
+			const G4ThreeVector& theCenter = theForcedEmission->GetTargetCenter();
+			outFS << std::setw(16) << "Target:" << theForcedEmission->GetTargetName() << '\n'
+				<< std::setw(21) << ' ' << std::setw(16) << "Outside RIndex:" << theForcedEmission->GetOutsideRIndex() << '\n'
+				<< std::setw(21) << ' ' << std::setw(16) << "Target center:";
+			if (theForcedEmission->IsResolved())
+				outFS << theCenter.x() / mm << ", " << theCenter.y() / mm << ", " << theCenter.z() / mm << " mm\n";
+			else
+				outFS << "Not found\n";
+			if (!theBiasing)
+				continue;
+			outFS << std::setw(21) << ' ';
+		}
+		outFS << std::setw(16) << "Delta phi:" << theBiasing->m_deltaPhi / deg << " deg\n"
+			<< std::setw(21) << ' ' << std::setw(16) << "Theta min:" << theBiasing->m_thetaMin / deg << " deg\n"
+			<< std::setw(21) << ' ' << std::setw(16) << "Theta max:" << theBiasing->m_thetaMax / deg << " deg\n";
+	}
 }
 #endif // boostEfficiency
 
 template <>
-void ProcessCsvData<int, double, double, double, double>::ReadMePrintAboutCurrentProjectData(std::ofstream& outFS) {
-	outFS << "\nThe total number of positive detections was: " << m_dataVec.size() << "\n\n";
+void ProcessCsvData<int, double, double, double, double, double>::ReadMePrintAboutCurrentProjectData(std::ofstream& outFS) {
+	outFS << "\nThe total number of positive detections was: " << m_dataVec.size() << '\n'
+		<< "The sum of weights of positive detections was: " << GetSumOfWeights() << "\n\n";
 	std::time_t cTimeType = std::chrono::system_clock::to_time_t(o_beginOfRunAction);
 	outFS << std::left << std::setw(35) << "The master RunAction began at: " << std::ctime(&cTimeType);
 	cTimeType = std::chrono::system_clock::to_time_t(o_endOfRunAction);
@@ -159,8 +189,8 @@ void ProcessCsvData<int, double, double, double, double>::ReadMePrintAboutCurren
 		}
 	}
 #ifdef boostEfficiency
-	outFS << std::right << std::setw(61) << std::setfill('=') << '\n' << "Limits in StackingAction:\n" << std::setfill(' ') << std::left;
-	m_taskGroup.exec([&outFS] { Task_StackingActionData(outFS); }); //seems like the simplest way to wrap a task
+	outFS << std::right << std::setw(61) << std::setfill('=') << '\n' << "Forced emission of Cherenkov models:\n" << std::setfill(' ') << std::left;
+	m_taskGroup.exec([&outFS] { Task_ForcedEmissionData(outFS); }); //seems like the simplest way to wrap a task
 	m_taskGroup.wait();
 #endif // boostEfficiency
 #ifdef followMinMaxValues
@@ -189,6 +219,7 @@ RunAction::RunAction() {
 	analysisManager->CreateNtupleDColumn("Wavelength");
 	analysisManager->CreateNtupleDColumn("x-coordinate");
 	analysisManager->CreateNtupleDColumn("y-coordinate");
+	analysisManager->CreateNtupleDColumn("Weight"); // of photons (weighted thinning of Cherenkov photons)
 	analysisManager->FinishNtuple();
 }
 
@@ -244,8 +275,9 @@ void RunAction::EndOfRunAction(const G4Run*) {
 		//do initial processing of raw data if csv is in use
 		if (outFileName.extension() == ".csv") {
 			TimeBench<std::chrono::microseconds> timeBNCH{ "RunAction::EndOfRunAction - processCSV" };
-			ProcessCsvData<int, double, double, double, double> processCsv{ "The_results", "ChR_project" };
+			ProcessCsvData<int, double, double, double, double, double> processCsv{ "The_results", "ChR_project" };
 			processCsv.MoveAFileToFinalDestination("LostEPerLayer.csv");
+			processCsv.SetWeightColumn<5>();
 			processCsv.Process_N_D_Data<2>(std::vector<double>{0.25, 0.5, 1., 2., 3.}, "Eff_PeakWaveLng", "efficiency.csv");
 			processCsv.Process_N_D_Data<2>(std::vector<double>{0.25, 0.5, 1., 2., 3.}, "PeakWaveLng");
 			//processCsv.Process_N_D_Data<3, 4>(std::vector<double>{3.}, "DetDist");
@@ -254,7 +286,8 @@ void RunAction::EndOfRunAction(const G4Run*) {
 #else
 	if (isMaster) {
 		TimeBench<std::chrono::microseconds> timeBNCH{ "RunAction::EndOfRunAction - processCSV" };
-		ProcessCsvData<int, double, double, double, double> processCsv{ "The_results", "ChR_project" };
+		ProcessCsvData<int, double, double, double, double, double> processCsv{ "The_results", "ChR_project" };
+		processCsv.SetWeightColumn<5>();
 		processCsv.Process_N_D_Data<1>(std::vector<double>{0.01}, "PeakWaveLng");
 	}
 #endif // standardRun
@@ -277,96 +310,21 @@ void RunAction::LoadPrimaryGeneratorData() {
 	g_primaryGenerator->SetDistanceZ(g_detectorConstruction->GetRadiatorThickness() / std::cos(g_detectorConstruction->GetRadiatorAngle()) +
 		5 * g_primaryGenerator->GetBeamSigma() * std::tan(g_detectorConstruction->GetRadiatorAngle()));
 #ifdef boostEfficiency
-	// Set delta phi and theta max and min
-	if (g_primaryGenerator->GetBeamSigma() == 536._um) {
-		g_stackingAction->SetDeltaPhi(0.8);
-		if (g_detectorConstruction->GetRadiatorAngle() == 22.0_deg) {
-			g_stackingAction->SetThetaMin(46.54_deg);
-			g_stackingAction->SetThetaMax(46.86_deg);
-		}
-		else if (g_detectorConstruction->GetRadiatorAngle() == 22.5_deg) {
-			g_stackingAction->SetThetaMin(46.65_deg);
-			g_stackingAction->SetThetaMax(46.97_deg);
-		}
-		else if (g_detectorConstruction->GetRadiatorAngle() == 23.0_deg) {
-			g_stackingAction->SetThetaMin(46.79_deg);
-			g_stackingAction->SetThetaMax(47.12_deg);
-		}
-		else if (g_detectorConstruction->GetRadiatorAngle() == 23.5_deg) {
-			g_stackingAction->SetThetaMin(46.93_deg);
-			g_stackingAction->SetThetaMax(47.24_deg);
-		}
-		else if (g_detectorConstruction->GetRadiatorAngle() == 24.0_deg) {
-			g_stackingAction->SetThetaMin(47.08_deg);
-			g_stackingAction->SetThetaMax(47.38_deg);
-		}
-	}
-	else if (g_primaryGenerator->GetBeamSigma() == 0._um) {
-		g_stackingAction->SetDeltaPhi(0.04);
-		if (g_detectorConstruction->GetRadiatorAngle() == 22.0_deg) {
-			g_stackingAction->SetThetaMin(46.59_deg);
-			g_stackingAction->SetThetaMax(46.79_deg);
-		}
-		else if (g_detectorConstruction->GetRadiatorAngle() == 22.5_deg) {
-			g_stackingAction->SetThetaMin(46.74_deg);
-			g_stackingAction->SetThetaMax(46.93_deg);
-		}
-		else if (g_detectorConstruction->GetRadiatorAngle() == 23.0_deg) {
-			g_stackingAction->SetThetaMin(46.88_deg);
-			g_stackingAction->SetThetaMax(47.05_deg);
-		}
-		else if (g_detectorConstruction->GetRadiatorAngle() == 23.5_deg) {
-			g_stackingAction->SetThetaMin(47.03_deg);
-			g_stackingAction->SetThetaMax(47.17_deg);
-		}
-		else if (g_detectorConstruction->GetRadiatorAngle() == 24.0_deg) {
-			g_stackingAction->SetThetaMin(47.16_deg);
-			g_stackingAction->SetThetaMax(47.29_deg);
+	// Cherenkov photons are emitted only towards the detector (their cones are found from the geometry, see G4ChRForcedEmission.hh)
+	// The target is set again in each run, so it's found again if the geometry has been changed, while the target
+	// and the outside RIndex set by /process/optical/G4ChRProcess/Models/forceEmissionTo are kept
+	if (G4CherenkovProcess* chProc = dynamic_cast<G4CherenkovProcess*>(G4ProcessTable::GetProcessTable()->FindProcess("Cherenkov", "e-"))) {
+		for (size_t i = 0; i < chProc->GetNumberOfRegisteredModels(); i++) {
+			G4BaseChR_Model* aModel = chProc->GetChRModel(i);
+			if (const G4ChRForcedEmission* theForcedEmission = aModel->GetForcedEmission())
+				aModel->SetForcedEmission(theForcedEmission->GetTargetName(), theForcedEmission->GetOutsideRIndex());
+			else
+				aModel->SetForcedEmission("detectorPhys");
 		}
 	}
 	else
-		g_stackingAction->SetDeltaPhi(1.0);
-	// Make sure one is aware of what's done if non-default values are used
-	if (!g_throwErrorForNonDefault)
-		return;
-	const PhysicsList* physList = dynamic_cast<const PhysicsList*>(G4RunManager::GetRunManager()->GetUserPhysicsList());
-	if (g_detectorConstruction->GetRadiatorThickness() - 100._um > 1.e-12_um ||
-		g_detectorConstruction->GetDetectorRadius() - 35._um > 1.e-12_um ||
-		g_detectorConstruction->GetDetectorDistance() - 37.6_cm < -1.e-12_um ||
-		g_primaryGenerator->GetParticleGun()->GetParticleDefinition()->GetParticleName() != "e-" ||
-		g_primaryGenerator->GetBeamSigma() - 600._um > 1.e-12_um ||
-		g_primaryGenerator->GetDivSigma() > 1.e-12 ||
-		g_primaryGenerator->GetParticleGun()->GetParticleEnergy() - 855._MeV > 1.e-12_MeV ||
-		std::abs(physList->GetRadiatorRangeCuts_gamma() - 1000._um) > 1.e-12_um ||
-		std::abs(physList->GetRadiatorRangeCuts_electron() - 1000._um) > 1.e-12_um ||
-		std::abs(physList->GetRadiatorRangeCuts_positron() - 1000._um) > 1.e-12_um ||
-		std::abs(physList->GetRadiatorRangeCuts_proton() - 1000._um) > 1.e-12_um) {
-
-		const char* err =
-			"You want to use non-default parameters while haven't disabled\n"
-			"the 'boostEfficiency' definition. That can be dangerous because\n"
-			"of the StackingAction class which directs and modifies produced\n"
-			"Cherenkov photons (to fly towards the detector). While that is\n"
-			"beneficial, make sure that you change the emission angle accordingly\n"
-			"and to read the comments in the 'StackingAction.cc' file. The\n"
-			"'boostEfficiency' definition enables using the most basic principles\n"
-			"of importance sampling.\n"
-			"On the other hand, the application execution has stopped just so you\n"
-			"would have noticed this message. If you are aware of the risks,\n"
-			"have read the comments and still want to proceed, change the \n"
-			"'g_throwErrorForNonDefault' flag in 'DefsNConsts.hh' to 'false'.\n"
-			"Otherwise, undefine 'boostEfficiency' in the 'DefsNConsts.hh' header.\n"
-			"The experimental values are:\n"
-			"Radiator thickness: 200  um (half-thickness: 100 um)\n"
-			"Radiator angle:     22.0/22.5/23.0/23.5/24.0 deg\n"
-			"Detector radius:    35   um\n"
-			"Detector distance:  37.6 cm\n"
-			"Particles:          e-\n"
-			"Beam Gauss sigma:   536  um\n"
-			"Particle energy:    855  MeV\n"
-			"+ the default cut values are used, i.e., 1000 um.";
-		G4Exception("RunAction::LoadPrimaryGeneratorData", "FE_RunAction02", FatalException, err);
-	}
+		G4Exception("RunAction::LoadPrimaryGeneratorData", "WE_RunAction02", JustWarning,
+			"G4CherenkovProcess not found, so photons are not directed towards the detector!\n");
 #endif // boostEfficiency
 }
 
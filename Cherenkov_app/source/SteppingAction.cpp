@@ -109,6 +109,7 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep) {
 	analysisManager->FillNtupleDColumn(2, 1.239841984e-6 * m * eV / (aStep->GetPostStepPoint()->GetTotalEnergy() * nm));
 	analysisManager->FillNtupleDColumn(3, localCoords.getX() / um);
 	analysisManager->FillNtupleDColumn(4, localCoords.getY() / um);
+	analysisManager->FillNtupleDColumn(5, aTrack->GetWeight());
 	analysisManager->AddNtupleRow();
 
 	G4int new_value = m_noOfDetections.fetch_add(1, std::memory_order_relaxed);
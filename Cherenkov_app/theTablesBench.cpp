@@ -0,0 +1,347 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+/*
+ABOUT THE FILE
+--------------
+
+ChR_tables_bench_exe builds Cherenkov physics tables of G4BaseChR_Model
+(the same G4ChRPhysicsTableService tables are used by
+G4StandardCherenkovProcess) without starting a run, i.e., without physics
+lists, geometry or run managers. For each number of beta steps, the tables
+are built twice - with CDF tables only for exotic RIndex (rejection
+sampling of standard materials) and with CDF tables for all materials -
+and the following is reported:
+1. the build time of all tables
+2. bytes of the table arenas of each material
+3. the max. yield and CDF errors in the middle of beta intervals
+   (G4ChRPhysicsTableService::EstimateInterpolationErrors)
+
+With -b, angular biasing (see G4ChRAngularBiasing.hh) is validated for each
+material with the last tables: the mean weighted number of photons per step
+that BiasPhi and ApplyAcceptance leave in a window (a phi window and a global
+cone around the Cherenkov angle) must agree with the mean number of unbiased
+photons in the same window within m_noOfAllowedSigmas. Forced emission (see
+G4ChRForcedEmission.hh) is validated in the same way, with a box target in
+front of a tilted exit face: the weighted yield of FindTargetCones,
+BiasPhiToTargetCones and ApplyAcceptance is compared with the unbiased
+photons inside their target cones. If any check fails, the exit code is 1.
+
+Materials are read through HelperToBuildMatPropTable, so the files have the
+same format as "refractive_index_data.txt". The usage is:
+ChR_tables_bench_exe [-f fileName] [-m materialName[:um|:eV]]... [-s betaSteps,...] [-t betaGridTolerance] [-e] [-b]
+-f - the file with refractive indices ("refractive_index_data.txt" by default)
+-m - a material from the file; ":um" (default) means wavelengths in micrometers and ":eV" energies in eV. NIST
+     materials are taken from G4NistManager, others are built (the composition doesn't affect the tables)
+     without -m, materials of DetectorConstruction are used (Diamond, G4_SILICON_DIOXIDE and fake_quartz:eV)
+-s - the numbers of beta steps to sweep (5,10,20,50,100,200 by default)
+-t - the adaptive beta-grid tolerance (betaSteps are not used then, so a single sweep step is done)
+-e - use the exact integration of RIndex
+-b - validate angular biasing and forced emission
+*/
+
+//User built headers
+#include "UnitsAndBench.hpp"
+#include "HelperToBuildMatPropTable.hpp"
+//G4 headers
+#include "G4ChRPhysicsTableService.hh"
+#include "G4ChRPhotonBatch.hh"
+#include "G4ChRAngularBiasing.hh"
+#include "G4ChRForcedEmission.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4NistManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Box.hh"
+#include "G4PVPlacement.hh"
+//std:: headers
+#include <chrono>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+struct BenchMaterial {
+	std::string m_name;
+	ChR::EnergyValue m_energyValue = ChR::EnergyValue::Wavelength;
+};
+
+static void PrintUsage() {
+	std::cout << "Usage: ChR_tables_bench_exe [-f fileName] [-m materialName[:um|:eV]]... [-s betaSteps,...] [-t betaGridTolerance] [-e] [-b]\n";
+}
+
+struct BiasingCheck {
+	static constexpr unsigned int m_noOfSteps = 20000;
+	static constexpr size_t m_noOfPhotons = 100;
+	static constexpr G4double m_beta = 0.9999;
+	static constexpr G4double m_noOfAllowedSigmas = 5.;
+	// forced emission - a cubic target at m_targetDistance from the exit face
+	static constexpr G4double m_targetHalfSize = 5._cm;
+	static constexpr G4double m_targetDistance = 1._m;
+};
+
+static G4ChREnergySampler PrepareBenchSampler(const G4Material* aMaterial) {
+	G4ChREnergySampler aSampler{};
+	aSampler.p_physData = &(*G4ChRPhysicsTableService::GetChRPhysDataVec())[aMaterial->GetIndex()];
+	aSampler.p_RIndex = aMaterial->GetMaterialPropertiesTable()->GetProperty(kRINDEX);
+	aSampler.m_beta = BiasingCheck::m_beta;
+	aSampler.m_mode = G4ChREnergySamplingMode::Uniform; // the sampler doesn't affect biasing
+	aSampler.m_minEnergy = aSampler.p_RIndex->Energy(0);
+	aSampler.m_maxEnergy = aSampler.p_RIndex->GetMaxEnergy();
+	return aSampler;
+}
+
+// true if biasedMean agrees with unbiasedMean within m_noOfAllowedSigmas
+static G4bool CompareYields(const G4Material* aMaterial, const char* windowName, const G4double unbiasedSum, const G4double unbiasedSum2,
+	const G4double biasedSum, const G4double biasedSum2) {
+	const G4double noOfSteps = BiasingCheck::m_noOfSteps;
+	const G4double unbiasedMean = unbiasedSum / noOfSteps;
+	const G4double biasedMean = biasedSum / noOfSteps;
+	const G4double sigma = std::sqrt(((unbiasedSum2 / noOfSteps - unbiasedMean * unbiasedMean) + (biasedSum2 / noOfSteps - biasedMean * biasedMean)) / noOfSteps);
+	const G4bool isOK = std::abs(biasedMean - unbiasedMean) <= BiasingCheck::m_noOfAllowedSigmas * sigma;
+	std::cout << "  " << std::setw(20) << std::left << aMaterial->GetName() << std::right << " | " << std::setw(11) << std::left << windowName << std::right
+		<< std::setprecision(5) << " | unbiased yield in window: " << unbiasedMean << " | weighted biased yield: " << biasedMean
+		<< " | sigma: " << sigma << (isOK ? " | OK\n" : " | FAILED\n");
+	return isOK;
+}
+
+// true if the mean weighted yield of biased steps in the window agrees with the unbiased one
+static G4bool CheckAngularBiasing(const G4Material* aMaterial, const G4ChRAngularBiasing& aBiasing, const char* windowName) {
+	// the primary goes along z, so the primary frame is the identity
+	const G4ChRRotationFrame primaryFrame = G4ChRRotationFrame::FromDirection({ 0., 0., 1. });
+	G4ChREnergySampler aSampler = PrepareBenchSampler(aMaterial);
+	G4ChRPhotonBatch aBatch;
+	G4double unbiasedSum = 0., unbiasedSum2 = 0., biasedSum = 0., biasedSum2 = 0.;
+	for (unsigned int step = 0; step < BiasingCheck::m_noOfSteps; step++) {
+		aBatch.Generate(aSampler, BiasingCheck::m_noOfPhotons);
+		G4double inWindow = 0.;
+		for (size_t i = 0; i < aBatch.m_noOfPhotons; i++) {
+			if (aBiasing.UsesThetaWindow() && (aBatch.m_cosTheta[i] > std::cos(aBiasing.m_thetaMin) || aBatch.m_cosTheta[i] < std::cos(aBiasing.m_thetaMax)))
+				continue;
+			if (aBiasing.UsesGlobalCone()) {
+				const G4ThreeVector aDirection{ aBatch.m_sinTheta[i] * aBatch.m_cosPhi[i], aBatch.m_sinTheta[i] * aBatch.m_sinPhi[i], aBatch.m_cosTheta[i] };
+				if (aDirection.dot(aBiasing.m_coneAxis) < std::cos(aBiasing.m_coneHalfAngle))
+					continue;
+			}
+			else if (aBiasing.UsesPhiWindow() && std::abs(std::remainder(aBatch.m_phi[i] - aBiasing.m_phiCenter, CLHEP::twopi)) > 0.5 * aBiasing.m_deltaPhi)
+				continue;
+			inWindow += 1.;
+		}
+		aBatch.m_randomBuffer.Clear();
+		unbiasedSum += inWindow;
+		unbiasedSum2 += inWindow * inWindow;
+
+		aBatch.Generate(aSampler, BiasingCheck::m_noOfPhotons);
+		aBatch.BiasPhi(aBiasing, primaryFrame);
+		aBatch.ApplyAcceptance(&aBiasing, primaryFrame);
+		G4double weightSum = 0.;
+		for (size_t i = 0; i < aBatch.m_noOfPhotons; i++)
+			weightSum += aBatch.m_isWeighted ? aBatch.m_weight[i] : 1.;
+		aBatch.m_randomBuffer.Clear();
+		biasedSum += weightSum;
+		biasedSum2 += weightSum * weightSum;
+	}
+	return CompareYields(aMaterial, windowName, unbiasedSum, unbiasedSum2, biasedSum, biasedSum2);
+}
+
+// true if the mean weighted yield of steps forced towards the target agrees with the unbiased yield inside the target cones
+static G4bool CheckForcedEmission(const G4Material* aMaterial, const G4ChRForcedEmission& aForcedEmission, const G4ChRExitPlane& anExitPlane) {
+	const G4ChRRotationFrame primaryFrame = G4ChRRotationFrame::FromDirection({ 0., 0., 1. });
+	// the step ends at the origin, i.e., just behind the exit face
+	const G4ThreeVector x0{ 0., 0., -1._mm };
+	const G4ThreeVector deltaPosition{ 0., 0., 1._mm };
+	G4ChREnergySampler aSampler = PrepareBenchSampler(aMaterial);
+	G4ChRPhotonBatch aBatch;
+	G4double unbiasedSum = 0., unbiasedSum2 = 0., biasedSum = 0., biasedSum2 = 0.;
+	for (unsigned int step = 0; step < BiasingCheck::m_noOfSteps; step++) {
+		aBatch.Generate(aSampler, BiasingCheck::m_noOfPhotons);
+		// photons that can never reach the target are removed, but phi is not changed
+		aBatch.FindTargetCones(aForcedEmission, anExitPlane, x0, deltaPosition);
+		G4double inCones = 0.;
+		for (size_t i = 0; i < aBatch.m_noOfPhotons; i++) {
+			const G4ThreeVector aDirection{ aBatch.m_sinTheta[i] * aBatch.m_cosPhi[i], aBatch.m_sinTheta[i] * aBatch.m_sinPhi[i], aBatch.m_cosTheta[i] };
+			const G4ThreeVector coneAxis{ aBatch.m_coneAxisX[i], aBatch.m_coneAxisY[i], aBatch.m_coneAxisZ[i] };
+			if (aDirection.dot(coneAxis) >= std::cos(aBatch.m_coneHalfAngle[i]))
+				inCones += 1.;
+		}
+		aBatch.m_randomBuffer.Clear();
+		unbiasedSum += inCones;
+		unbiasedSum2 += inCones * inCones;
+
+		aBatch.Generate(aSampler, BiasingCheck::m_noOfPhotons);
+		aBatch.FindTargetCones(aForcedEmission, anExitPlane, x0, deltaPosition);
+		aBatch.BiasPhiToTargetCones(primaryFrame);
+		aBatch.ApplyAcceptance(nullptr, primaryFrame);
+		G4double weightSum = 0.;
+		for (size_t i = 0; i < aBatch.m_noOfPhotons; i++)
+			weightSum += aBatch.m_weight[i];
+		aBatch.m_randomBuffer.Clear();
+		biasedSum += weightSum;
+		biasedSum2 += weightSum * weightSum;
+	}
+	return CompareYields(aMaterial, "target box", unbiasedSum, unbiasedSum2, biasedSum, biasedSum2);
+}
+
+// a box target in front of an exit face whose normal is the mean Cherenkov direction at phi == 0
+static G4bool RunForcedEmissionCheck(const G4Material* aMaterial, const G4double meanCosTheta) {
+	const G4ThreeVector theNormal{ std::sqrt(1. - meanCosTheta * meanCosTheta), 0., meanCosTheta };
+	G4ChRExitPlane anExitPlane;
+	anExitPlane.m_point = 1._mm * theNormal;
+	anExitPlane.m_normal = theNormal;
+	anExitPlane.m_isValid = true;
+
+	G4Material* vacuum = G4NistManager::Instance()->FindOrBuildMaterial("G4_Galactic");
+	const G4String targetName = aMaterial->GetName() + "_benchTarget";
+	G4Box* worldSolid = new G4Box{ "benchWorldSolid", 2._m, 2._m, 2._m };
+	G4LogicalVolume* worldLogic = new G4LogicalVolume{ worldSolid, vacuum, aMaterial->GetName() + "_benchWorldLogic" };
+	new G4PVPlacement{ nullptr, G4ThreeVector{}, worldLogic, aMaterial->GetName() + "_benchWorldPhys", nullptr, false, 0 };
+	G4Box* targetSolid = new G4Box{ "benchTargetSolid", BiasingCheck::m_targetHalfSize, BiasingCheck::m_targetHalfSize, BiasingCheck::m_targetHalfSize };
+	G4LogicalVolume* targetLogic = new G4LogicalVolume{ targetSolid, vacuum, aMaterial->GetName() + "_benchTargetLogic" };
+	new G4PVPlacement{ nullptr, anExitPlane.m_point + BiasingCheck::m_targetDistance * theNormal, targetLogic, targetName, worldLogic, false, 0 };
+
+	G4ChRForcedEmission aForcedEmission{ targetName };
+	if (!aForcedEmission.Resolve()) {
+		std::cout << "  " << std::setw(20) << std::left << aMaterial->GetName() << std::right << " | target box  | the target is not found | FAILED\n";
+		return false;
+	}
+	return CheckForcedEmission(aMaterial, aForcedEmission, anExitPlane);
+}
+
+static G4bool RunBiasingCheck(const std::vector<G4Material*>& theMaterials) {
+	std::cout << "Angular biasing and forced emission - " << BiasingCheck::m_noOfSteps << " steps of " << BiasingCheck::m_noOfPhotons << " photons (beta: " << BiasingCheck::m_beta << ")\n";
+	G4bool isOK = true;
+	for (const G4Material* aMaterial : theMaterials) {
+		G4ChRAngularBiasing aPhiWindow{};
+		aPhiWindow.m_phiCenter = CLHEP::halfpi;
+		aPhiWindow.m_deltaPhi = 0.3;
+		isOK = CheckAngularBiasing(aMaterial, aPhiWindow, "phi window") && isOK;
+
+		// a cone around the mean Cherenkov direction at phi == 0, so some photons cannot reach it at all
+		G4ChREnergySampler aSampler = PrepareBenchSampler(aMaterial);
+		G4ChRPhotonBatch aBatch;
+		aBatch.Generate(aSampler, BiasingCheck::m_noOfPhotons);
+		G4double meanCosTheta = 0.;
+		for (size_t i = 0; i < aBatch.m_noOfPhotons; i++)
+			meanCosTheta += aBatch.m_cosTheta[i] / aBatch.m_noOfPhotons;
+		aBatch.m_randomBuffer.Clear();
+		G4ChRAngularBiasing aGlobalCone{};
+		aGlobalCone.m_coneAxis = G4ThreeVector{ std::sqrt(1. - meanCosTheta * meanCosTheta), 0., meanCosTheta };
+		aGlobalCone.m_coneHalfAngle = 0.05;
+		isOK = CheckAngularBiasing(aMaterial, aGlobalCone, "global cone") && isOK;
+		isOK = RunForcedEmissionCheck(aMaterial, meanCosTheta) && isOK;
+	}
+	std::cout << std::defaultfloat;
+	return isOK;
+}
+
+static void RunTablesBench(const std::vector<G4Material*>& theMaterials, const unsigned int noOfBetaSteps, const G4bool useCDFForAll) {
+	G4ChRPhysicsTableService::SetNoOfBetaSteps(noOfBetaSteps);
+	G4ChRPhysicsTableService::SetUseRejectionSampling(!useCDFForAll);
+	G4ChRPhysicsTableService::ClearPhysicsTables();
+	const auto buildStart = std::chrono::steady_clock::now();
+	G4ChRPhysicsTableService::BuildPhysicsTables();
+	const std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - buildStart;
+
+	const auto physDataVec = G4ChRPhysicsTableService::GetChRPhysDataVec();
+	std::cout << "betaSteps: " << noOfBetaSteps << (useCDFForAll ? " | CDF tables for all materials" : " | CDF tables for exotic RIndex only")
+		<< " | build time: " << std::fixed << std::setprecision(3) << buildTime.count() << " ms\n";
+	for (const G4Material* aMaterial : theMaterials) {
+		const G4ChRPhysTableData& theData = (*physDataVec)[aMaterial->GetIndex()];
+		const G4ChRInterpolationErrors theErrors = G4ChRPhysicsTableService::EstimateInterpolationErrors(aMaterial->GetIndex());
+		std::cout << "  " << std::setw(20) << std::left << aMaterial->GetName() << std::right
+			<< " | betaNodes: " << std::setw(5) << theData.GetNoOfBetaNodes()
+			<< " | energyNodes: " << std::setw(4) << theData.GetNoOfEnergyNodes()
+			<< " | bytes: " << std::setw(8) << theData.GetArenaSizeInBytes()
+			<< std::scientific << std::setprecision(3)
+			<< " | yield error: " << theErrors.m_yieldError << " | CDF error: " << theErrors.m_CDFError << '\n';
+	}
+	std::cout << std::defaultfloat;
+}
+
+int main(int argc, char** argv) {
+	G4String fileName = "refractive_index_data.txt";
+	std::vector<BenchMaterial> benchMaterials;
+	std::vector<unsigned int> betaStepsVec{ 5, 10, 20, 50, 100, 200 };
+	G4bool checkBiasing = false;
+	for (int i = 1; i < argc; i++) {
+		const std::string anArgument = argv[i];
+		if (anArgument == "-e") {
+			G4ChRPhysicsTableService::SetUseExactIntegration(true);
+			continue;
+		}
+		if (anArgument == "-b") {
+			checkBiasing = true;
+			continue;
+		}
+		if (i + 1 == argc || (anArgument != "-f" && anArgument != "-m" && anArgument != "-s" && anArgument != "-t")) {
+			PrintUsage();
+			return 1;
+		}
+		const std::string aValue = argv[++i];
+		try {
+			if (anArgument == "-f")
+				fileName = aValue;
+			else if (anArgument == "-m") {
+				const size_t unitLoc = aValue.rfind(':');
+				if (unitLoc == std::string::npos)
+					benchMaterials.push_back({ aValue, ChR::EnergyValue::Wavelength });
+				else
+					benchMaterials.push_back({ aValue.substr(0, unitLoc), aValue.substr(unitLoc + 1) == "eV" ? ChR::EnergyValue::Energy : ChR::EnergyValue::Wavelength });
+			}
+			else if (anArgument == "-s") {
+				betaStepsVec.clear();
+				std::istringstream iSS{ aValue };
+				for (std::string aStep; std::getline(iSS, aStep, ',');)
+					betaStepsVec.push_back(static_cast<unsigned int>(std::stoul(aStep)));
+			}
+			else /*if (anArgument == "-t")*/ {
+				G4ChRPhysicsTableService::SetBetaGridTolerance(std::stod(aValue));
+				betaStepsVec.resize(1);
+			}
+		}
+		catch (...) {
+			std::cout << "The value " << std::quoted(aValue) << " of " << anArgument << " cannot be converted!\n";
+			PrintUsage();
+			return 1;
+		}
+	}
+	if (benchMaterials.empty())
+		benchMaterials = { { "Diamond", ChR::EnergyValue::Wavelength }, { "G4_SILICON_DIOXIDE", ChR::EnergyValue::Wavelength }, { "fake_quartz", ChR::EnergyValue::Energy } };
+	if (betaStepsVec.empty() || std::find(betaStepsVec.begin(), betaStepsVec.end(), 0U) != betaStepsVec.end()) {
+		std::cout << "The number of beta steps must be at least 1!\n";
+		return 1;
+	}
+
+	G4NistManager* nist = G4NistManager::Instance();
+	ChR::HelperToBuildMatPropTable obj{};
+	std::vector<G4Material*> theMaterials;
+	G4Box* aSolid = new G4Box{ "benchSolid", 1._cm, 1._cm, 1._cm };
+	for (const BenchMaterial& aBenchMaterial : benchMaterials) {
+		G4Material* aMaterial = nist->FindOrBuildMaterial(aBenchMaterial.m_name, false, false);
+		if (!aMaterial)
+			aMaterial = nist->BuildMaterialWithNewDensity(aBenchMaterial.m_name, "G4_WATER", 1. * g / cm3);
+		if (aBenchMaterial.m_energyValue == ChR::EnergyValue::Energy)
+			obj.FillMatPropertiesVectors(fileName.c_str(), aMaterial, ChR::EnergyValue::Energy, 1._eV, '\t', "Energy", "RINDEX");
+		else
+			obj.FillMatPropertiesVectors(fileName.c_str(), aMaterial, ChR::EnergyValue::Wavelength, 1._um, '\t', "Energy", "RINDEX");
+		// exotic flags are taken from logical volumes (see G4ChRPhysicsTableService::GetExoticRIndexFlag), as in a run
+		new G4LogicalVolume{ aSolid, aMaterial, aBenchMaterial.m_name + "_benchLogic" };
+		theMaterials.push_back(aMaterial);
+	}
+
+	for (const unsigned int noOfBetaSteps : betaStepsVec) {
+		RunTablesBench(theMaterials, noOfBetaSteps, false);
+		RunTablesBench(theMaterials, noOfBetaSteps, true);
+	}
+	const G4bool isOK = !checkBiasing || RunBiasingCheck(theMaterials);
+	G4ChRPhysicsTableService::ClearPhysicsTables();
+	return isOK ? 0 : 1;
+}
\ No newline at end of file
@@ -19,45 +19,42 @@ models can use the same method. On the other hand, the latter method is
 pure virtual and one should decide what kind of angular and spectral
 distributions should be used.
 
-The number of photons is generated according to equation:
-dN/dl = 2 * Pi * alpha * z^2 / (h * c) * (leftIntegral - rightIntegral),
-where:
-leftIntegral = \int dE
-rightIntegral = \int dE / (beta^2 * RIndex^2)
-with limits: Emin -> Emax
-
-The physics lists of the G4BaseChR_Model are prepared to analyze any kind of
-RIndex dependency and are saved as a 'std::vector<G4ChRPhysTableData>',
-where 'G4ChRPhysTableData' is a helper struct containing values based around
-specific beta values:
-1. beta values - specific beta values that are used when a charged particle
-                 cannot emit Cherenkov photons on the whole RIndex spectrum
-2. left integral value (dE)
-3. right integral value (dE / RIndex^2)
-4. p_valuesCDF - to keep normalized CDF values used to generate spectral
-				 distribution of ChR for low beta values. The value is 'nullptr'
-				 if non-exotic refractive indices are used
-
-And a vector of values for building CDFs for particles with beta values higher
-than betaMax, if a material has an exotic refractive index:
-5. p_bigBetaCDFVector - the value is mostly 'nullptr'. It is used for materials
-						with exotic refractive indices, and beta values greater
-						than the betaMax value (the value that can generate ChR
-						photons on the whole RIndex spectrum)
-
-Note that the ChR currently doesn't produce ChR photons in X-ray region (gammas).
-Also, the whole idea with the spectral distribution of exotic materials  is based
-on the theory and it still must be confirmed by an experiment.
+Physics tables (number of photons and CDFs for the spectral distribution) are
+not owned by the models - all models (and G4StandardCherenkovProcess) use the
+same tables of G4ChRPhysicsTableService, so they are built only once. The
+parameters of those tables (number of beta steps, adaptive beta-grid
+tolerance and rejection sampling) are set there as well.
 
 Some other member variables:
-1. m_noOfBetaSteps - for filling the beta-values vector from betaMin to
-                     betaMax with "m_noOfBetaStep + 1" nodes
-2. m_includeFiniteThickness - Cherenkov models should mark if they can
+1. m_includeFiniteThickness - Cherenkov models should mark if they can
                      consider thin radiators adequately (currently not used,
 					 but it could be used for some safety conditions)
-3. m_useModelWithEnergyLoss - set to true to include conservation energy law
+2. m_useModelWithEnergyLoss - set to true to include conservation energy law
                      (according to Tamm-Frank theory, it's not satisfied; the
 					 values are negligible)
+3. m_useAliasSampler - set to true to sample photon energies of exotic
+                     materials through alias tables (O(1)) instead of the
+					 inverse CDF (binary search); the distribution is the same
+4. m_angularBiasing - an acceptance window of photons (see
+                     G4ChRAngularBiasing.hh); used only after SetAngularBiasing
+					 is called. Models generate photons only inside the window
+					 and photons carry statistical weights
+5. p_forcedEmission - photons are generated only in cones of directions that
+                     reach a target volume (see G4ChRForcedEmission.hh); used
+					 only after SetForcedEmission is called. It replaces the
+					 phi window of m_angularBiasing (a warning is given if both
+					 are set), while its theta window and global cone are still
+					 applied as acceptance cuts
+
+Photons are generated in two stages through m_photonBatch (see
+G4ChRPhotonBatch.hh) - sampling into structure-of-arrays columns and then
+creating tracks - and PrepareEnergySampler selects how the energies of a
+step are sampled.
+
+Models don't look up tables, RINDEX or G4CherenkovMatData of the current
+volume - G4CherenkovProcess passes a G4ChRResolvedOptics descriptor of the
+volume to both PostStepModelIntLength and PostStepModelDoIt, and it keeps the
+G4ChRPhysicsTableSnapshot the descriptor points to.
 
 Other than member variables, most virtual methods are directly related to the
 G4VProcess virtual methods.
@@ -69,22 +66,22 @@ G4VProcess virtual methods.
 
 //G4 headers
 #include "G4ForceCondition.hh"
-#include "G4ChRPhysicsTableData.hh"
+#include "G4ChRPhysicsTableService.hh"
+#include "G4ChRResolvedOptics.hh"
+#include "G4ChRPhotonBatch.hh"
+#include "G4ChRAngularBiasing.hh"
+#include "G4ChRForcedEmission.hh"
 #include "G4Material.hh"
+#include "GlobalFunctions.hh"
 
 class G4Track;
 class G4VParticleChange;
 class G4ParticleChange;
 class G4ParticleDefinition;
 class G4Step;
-class G4ExtraOpticalParameters_Messenger;
-struct G4CherenkovMatData;
 
 class G4BaseChR_Model {
-	friend G4ExtraOpticalParameters_Messenger;
 public:
-	using G4ChRPhysicsTableVector = std::vector<G4ChRPhysTableData>;
-
 	G4BaseChR_Model(const char* name, const unsigned char verboseLevel = 0);
 	virtual ~G4BaseChR_Model();
 	G4BaseChR_Model(const G4BaseChR_Model&) = delete;
@@ -93,82 +90,96 @@ public:
 	G4BaseChR_Model& operator=(G4BaseChR_Model&&) /*noexcept*/ = delete;
 
 	//=======Methods according G4VProcess=======
-	[[nodiscard]] virtual G4double PostStepModelIntLength(const G4Track& aTrack, G4double previousStepSize, G4ForceCondition* condition);
+	[[nodiscard]] virtual G4double PostStepModelIntLength(const G4Track& aTrack, G4double previousStepSize, G4ForceCondition* condition,
+		const G4ChRResolvedOptics& theOptics);
 
-	virtual G4VParticleChange* PostStepModelDoIt(const G4Track& aTrack, const G4Step& aStep, const G4CherenkovMatData& selectedData) = 0;
+	virtual G4VParticleChange* PostStepModelDoIt(const G4Track& aTrack, const G4Step& aStep, const G4ChRResolvedOptics& theOptics) = 0;
 
 	virtual inline void PrepareModelPhysicsTable(const G4ParticleDefinition&) {};
 	virtual inline void BuildModelPhysicsTable(const G4ParticleDefinition&);
 
-	//it might be good to load binaries for some more complex physics tables
-	virtual inline G4bool StoreModelPhysicsTable(const G4ParticleDefinition*, const G4String&, G4bool) { return true; }
-	virtual inline G4bool RetrieveModelPhysicsTable(const G4ParticleDefinition*, const G4String&, G4bool) { return true; }
+	//binary files (see G4ChRPhysicsTableCache.hh) to skip the integration when restarting with the same materials
+	//after retrieving tables, BuildModelPhysicsTable is still called to prepare model-specific data
+	virtual G4bool StoreModelPhysicsTable(const G4ParticleDefinition*, const G4String& directory, G4bool ascii);
+	virtual G4bool RetrieveModelPhysicsTable(const G4ParticleDefinition*, const G4String& directory, G4bool ascii);
 
 	virtual inline void PrepareWorkerModelPhysicsTable(const G4ParticleDefinition& aParticle);
 	virtual inline void BuildWorkerModelPhysicsTable(const G4ParticleDefinition& aParticle);
 
 	virtual inline void DumpModelInfo() const;
-	static void PrintChRPhysDataVec(const unsigned char printLevel = 0,  const G4Material* aMaterial = nullptr);
-	// aMaterial == nullptr -> prints physics tables for all registered materials
-	// aMaterial == someMaterial -> prints physics tables for a someMaterial
-	// printLevel == 0 -> print only basic available information about registered physics tables
-	// printLevel == 1 -> print standard + p_valuesCDF values
-	// printLevel >= 2 -> print all available information about registered physics tables
 
 	//=======Set inlines=======
-	inline static unsigned int SetNoOfBetaSteps(const unsigned int);
 	inline void SetVerboseLevel(const unsigned char);
 	inline void SetUseModelWithEnergyLoss(const G4bool);
+	inline void SetUseAliasSampler(const G4bool);
+	// warns if the phi window is ignored because forced emission is used
+	void SetAngularBiasing(const G4ChRAngularBiasing&);
+	inline void DisableAngularBiasing();
+	// photons are directed towards the physical volume targetName (e.g., a detector)
+	// warns if the phi window of angular biasing is ignored then
+	void SetForcedEmission(const G4String& targetName, const G4double outsideRIndex = 1.);
+	inline void DisableForcedEmission();
 
 	//=======Get inlines=======
 	[[nodiscard]] inline const char* GetChRModelName() const;
-	[[nodiscard]] inline static unsigned int GetNoOfBetaSteps();
 	[[nodiscard]] inline unsigned char GetVerboseLevel() const;
 	[[nodiscard]] inline G4bool GetFiniteThicknessCondition() const;
 	[[nodiscard]] inline G4bool GetUseModelWithEnergyLoss() const;
-	[[nodiscard]] inline const static G4ChRPhysicsTableVector& GetChRPhysDataVec();
+	[[nodiscard]] inline G4bool GetUseAliasSampler() const;
+	// nullptr if angular biasing is not used
+	[[nodiscard]] inline const G4ChRAngularBiasing* GetAngularBiasing() const;
+	// nullptr if forced emission is not used
+	[[nodiscard]] inline const G4ChRForcedEmission* GetForcedEmission() const;
 
 protected:
-	[[nodiscard]] virtual G4double CalculateAverageNumberOfPhotons(const G4double aCharge, const G4double betaValue, const size_t materialID);
+	[[nodiscard]] virtual G4double CalculateAverageNumberOfPhotons(const G4double aCharge, const G4double betaValue, const G4ChRPhysTableData& physData);
+	// selects how photon energies of a step are sampled (see G4ChRPhotonBatch.hh)
+	[[nodiscard]] G4ChREnergySampler PrepareEnergySampler(const G4double beta, const G4ChRResolvedOptics& theOptics) const;
+	// finds the target cones of photons in m_photonBatch; false if forced emission is not used (or its target is not found)
+	G4bool FindTargetCones(const G4Step& aStep, const G4ChRResolvedOptics& theOptics);
 
-	static G4ChRPhysicsTableVector m_ChRPhysDataVec;
-	static unsigned int m_noOfBetaSteps;
 	//=======Member variables=======
 	G4ParticleChange* p_particleChange = nullptr;
+	G4ChRPhotonBatch m_photonBatch; // reused between steps
+	G4ChRAngularBiasing m_angularBiasing;
+	G4ChRForcedEmission* p_forcedEmission = nullptr;
 	const char* m_ChRModelName;
 	unsigned char m_verboseLevel;
 	G4bool m_includeFiniteThickness;
 	G4bool m_useModelWithEnergyLoss;
-	// 5 wasted bytes on x64
+	G4bool m_useAliasSampler;
+	G4bool m_useAngularBiasing;
+	// 3 wasted bytes on x64
 	//==============================
 
 private:
 	G4BaseChR_Model() = delete;
-	// the following method tries, but adds physics table with exotic RI or not. Nevertheless, they primarily use exotic if possible
-	static G4bool AddExoticRIndexPhysicsTable(const size_t materialID, G4bool forceExoticFlag = false);
-	static void RemoveExoticRIndexPhysicsTable(const size_t materialID);
+	// forced emission replaces the phi window, so it's not applied
+	void WarnIfPhiWindowIsIgnored() const;
 };
 
 //=======Set inlines=======
-unsigned int G4BaseChR_Model::SetNoOfBetaSteps(const unsigned int value) {
-	unsigned int temp = m_noOfBetaSteps;
-	m_noOfBetaSteps = value;
-	return temp;
-}
 void G4BaseChR_Model::SetVerboseLevel(const unsigned char value) {
 	m_verboseLevel = value;
 }
 void G4BaseChR_Model::SetUseModelWithEnergyLoss(const G4bool value) {
 	m_useModelWithEnergyLoss = value;
 }
+void G4BaseChR_Model::SetUseAliasSampler(const G4bool value) {
+	m_useAliasSampler = value;
+}
+void G4BaseChR_Model::DisableAngularBiasing() {
+	m_useAngularBiasing = false;
+}
+void G4BaseChR_Model::DisableForcedEmission() {
+	delete p_forcedEmission;
+	p_forcedEmission = nullptr;
+}
 
 //=======Get inlines=======
 const char* G4BaseChR_Model::GetChRModelName() const {
 	return m_ChRModelName;
 }
-unsigned int G4BaseChR_Model::GetNoOfBetaSteps() {
-	return m_noOfBetaSteps;
-}
 unsigned char G4BaseChR_Model::GetVerboseLevel() const {
 	return m_verboseLevel;
 }
@@ -178,21 +189,21 @@ G4bool G4BaseChR_Model::GetFiniteThicknessCondition() const {
 G4bool G4BaseChR_Model::GetUseModelWithEnergyLoss() const {
 	return m_useModelWithEnergyLoss;
 }
-const G4BaseChR_Model::G4ChRPhysicsTableVector& G4BaseChR_Model::GetChRPhysDataVec() {
-	return m_ChRPhysDataVec;
+G4bool G4BaseChR_Model::GetUseAliasSampler() const {
+	return m_useAliasSampler;
+}
+const G4ChRAngularBiasing* G4BaseChR_Model::GetAngularBiasing() const {
+	return m_useAngularBiasing ? &m_angularBiasing : nullptr;
+}
+const G4ChRForcedEmission* G4BaseChR_Model::GetForcedEmission() const {
+	return p_forcedEmission;
 }
 
 //=======Additional inlines=======
 void G4BaseChR_Model::BuildModelPhysicsTable(const G4ParticleDefinition&) {
-	std::size_t numOfMaterials = G4Material::GetNumberOfMaterials();
-	if (m_ChRPhysDataVec.size() == numOfMaterials)
-		return;
-	m_ChRPhysDataVec = G4ChRPhysicsTableVector{}; //in case some materials were deleted - rebuilding all physics tables
-	m_ChRPhysDataVec.reserve(numOfMaterials);
-	for (size_t i = 0; i < numOfMaterials; i++)
-		AddExoticRIndexPhysicsTable(i);
-	if (m_verboseLevel > 0)
-		PrintChRPhysDataVec();
+	// the tables are shared, so only the first model (or process) finds and builds tables of added or changed materials
+	// on workers, nothing is built - they only take the tables published by the master (G4CherenkovProcess)
+	G4ChRPhysicsTableService::BuildPhysicsTables(m_verboseLevel);
 }
 
 void G4BaseChR_Model::PrepareWorkerModelPhysicsTable(const G4ParticleDefinition& aParticle) {
@@ -0,0 +1,82 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+/*
+ABOUT THE HEADER
+----------------
+
+G4ChRAngularBiasing is an acceptance window of Cherenkov photons that is
+used by G4BaseChR_Model (see SetAngularBiasing). Photons are generated only
+inside the window, so photons that would never reach a (small) detector are
+never allocated, and the weight of each photon (G4Track::GetWeight) makes
+the expected detected yield the same as without biasing. The number of
+photons of a step is not changed, i.e., all of them are moved into the
+window, so each photon stands for the fraction of photons that would have
+been emitted into the window without biasing:
+1. phi window      - phi (of G4ThreeVector::rotateUz(p0), where p0 is the
+                     direction of the primary) is sampled uniformly in
+                     [m_phiCenter - m_deltaPhi / 2, m_phiCenter + m_deltaPhi / 2]
+                     and photons have the weight m_deltaPhi / (2 * pi)
+2. global cone     - used instead of the phi window if m_coneHalfAngle < pi;
+                     for each photon, phi is sampled only in the interval for
+                     which the photon direction is inside the cone around
+                     m_coneAxis (global), and photons have the weight
+                     (interval width) / (2 * pi); photons whose theta cannot
+                     reach the cone at all are not created
+3. theta window    - theta relative to p0 is determined by the photon energy
+                     (and smearing of G4ThinTargetChR_Model), so photons
+                     outside [m_thetaMin, m_thetaMax] are not created
+                     (Russian roulette with zero survival, i.e., no weight)
+
+Biasing is unbiased only if no photon outside the window could have been
+detected. G4ThinTargetChR_Model finds phi intervals of the global cone
+before theta is smeared (smearing depends on phi), so the cone of each
+photon is widened by a few sigma of its smearing when phi is sampled, and
+the exact cone and the theta window are applied after smearing.
+To find the cone of each photon from the geometry (a target volume, the exit
+face of the radiator and refraction), see G4ChRForcedEmission.hh.
+*/
+
+#pragma once
+#ifndef G4ChRAngularBiasing_hh
+#define G4ChRAngularBiasing_hh
+
+//G4 headers
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4PhysicalConstants.hh"
+
+struct G4ChRAngularBiasing {
+	// relative to the primary
+	G4double m_thetaMin = 0.;
+	G4double m_thetaMax = CLHEP::pi;
+	G4double m_phiCenter = CLHEP::halfpi;
+	G4double m_deltaPhi = CLHEP::twopi;
+	// global; m_coneAxis must be a unit vector
+	G4ThreeVector m_coneAxis{ 0., 0., 1. };
+	G4double m_coneHalfAngle = CLHEP::pi;
+
+	[[nodiscard]] inline G4bool UsesGlobalCone() const;
+	[[nodiscard]] inline G4bool UsesPhiWindow() const;
+	[[nodiscard]] inline G4bool UsesThetaWindow() const;
+};
+
+//=======Additional inlines=======
+G4bool G4ChRAngularBiasing::UsesGlobalCone() const {
+	return m_coneHalfAngle < CLHEP::pi;
+}
+
+G4bool G4ChRAngularBiasing::UsesPhiWindow() const {
+	return !UsesGlobalCone() && m_deltaPhi < CLHEP::twopi;
+}
+
+G4bool G4ChRAngularBiasing::UsesThetaWindow() const {
+	return m_thetaMin > 0. || m_thetaMax < CLHEP::pi;
+}
+
+#endif // !G4ChRAngularBiasing_hh
\ No newline at end of file
@@ -0,0 +1,120 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+/*
+ABOUT THE HEADER
+----------------
+
+G4ChRForcedEmission directs Cherenkov photons of a model towards a target
+volume (see G4BaseChR_Model::SetForcedEmission), e.g., a small detector far
+away from the radiator. Instead of fixed windows (G4ChRAngularBiasing.hh),
+the cone of directions that reach the target is found for each photon from
+the geometry:
+1. the target    - the physical volume with the name m_targetName (the first
+                   one in G4PhysicalVolumeStore), approximated by the bounding
+                   box of its solid (G4VSolid::GetExtent), i.e., by the 8
+                   corners of the box (global)
+2. the exit face - the plane through which photons leave the radiator
+                   (FindExitPlane), i.e., the face of the thin-target slab
+                   (see G4ThinTargetChR_Model) that faces the target, or the
+                   surface of the current solid where the line towards the
+                   target leaves it
+3. refraction    - Snell's law at the exit face, with the refractive index of
+                   each photon inside and m_outsideRIndex outside
+FindCone inverts the refraction: the direction outside (from the exit point
+towards the target center) is refracted back into the radiator, and, as the
+exit point depends on that direction, the axis of the cone is found
+iteratively, starting from the exit point on the line from the emission point
+towards the target center. The half-angle of the cone outside is the largest
+angle between the axis and a corner of the box seen from the exit point (a
+cone narrower than 90 deg is convex, so it contains the whole box), and it's
+scaled by the larger of the two (in-plane and out-of-plane) angular
+magnifications of the refraction. Therefore, the cone contains all directions
+that reach the target (to the first order in the half-angle, i.e., for
+targets that are small compared to their distance).
+
+G4ChRPhotonBatch then samples phi of each photon only in the interval in which
+its direction is inside its cone, and photons get the weight
+(interval width) / (2 * pi), i.e., the probability that the photon would have
+been emitted into the interval without forced emission, so the expected
+detected yield is the same as without forced emission. G4ThinTargetChR_Model smears theta after phi is
+sampled, so it widens the cone of each photon by a few sigma of its smearing
+before phi is sampled, and exact cones are applied after smearing.
+
+The target is found when the first photons are directed, so it can be set
+before the geometry is built. If the geometry changes, SetForcedEmission
+should be called again. Reflections are not considered, i.e., photons that
+could reach the target only after a reflection (or through other volumes
+between the radiator and the target) are not created.
+*/
+
+#pragma once
+#ifndef G4ChRForcedEmission_hh
+#define G4ChRForcedEmission_hh
+
+//G4 headers
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+//std:: headers
+#include <array>
+
+class G4Step;
+struct G4ChRResolvedOptics;
+
+// the exit face of the radiator for photons of a step; m_normal is the (unit) outward normal
+struct G4ChRExitPlane {
+	G4ThreeVector m_point;
+	G4ThreeVector m_normal;
+	G4bool m_isValid = false;
+};
+
+class G4ChRForcedEmission {
+public:
+	explicit G4ChRForcedEmission(const G4String& targetName, const G4double outsideRIndex = 1.);
+
+	// finds the target center and corners (global); false if there's no such volume
+	G4bool Resolve();
+	// for photons of aStep (the exit face is found for the middle of the step)
+	[[nodiscard]] G4ChRExitPlane FindExitPlane(const G4Step& aStep, const G4ChRResolvedOptics& theOptics) const;
+	// the cone (global) of directions from anEmissionPoint that reach the target; false if the target cannot be reached
+	G4bool FindCone(const G4ThreeVector& anEmissionPoint, const G4double RIndex, const G4ChRExitPlane& anExitPlane,
+		G4ThreeVector& coneAxis, G4double& coneHalfAngle) const;
+
+	//=======Get inlines=======
+	[[nodiscard]] inline const G4String& GetTargetName() const;
+	[[nodiscard]] inline G4double GetOutsideRIndex() const;
+	[[nodiscard]] inline const G4ThreeVector& GetTargetCenter() const;
+	[[nodiscard]] inline G4bool IsResolved() const;
+
+private:
+	// of the exit point in FindCone
+	static constexpr unsigned char m_noOfIterations = 3;
+
+	G4String m_targetName;
+	G4ThreeVector m_targetCenter;
+	std::array<G4ThreeVector, 8> m_targetCorners;
+	G4double m_outsideRIndex;
+	G4bool m_isResolved = false;
+	G4bool m_wasWarned = false; // the target is not found
+};
+
+//=======Get inlines=======
+const G4String& G4ChRForcedEmission::GetTargetName() const {
+	return m_targetName;
+}
+G4double G4ChRForcedEmission::GetOutsideRIndex() const {
+	return m_outsideRIndex;
+}
+const G4ThreeVector& G4ChRForcedEmission::GetTargetCenter() const {
+	return m_targetCenter;
+}
+G4bool G4ChRForcedEmission::IsResolved() const {
+	return m_isResolved;
+}
+
+#endif // !G4ChRForcedEmission_hh
\ No newline at end of file
@@ -0,0 +1,213 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+/*
+ABOUT THE HEADER
+----------------
+
+Photon generation of Cherenkov models (and G4StandardCherenkovProcess) is
+split into two stages:
+1. G4ChRPhotonBatch::Generate - samples all photons of a step and fills
+   structure-of-arrays columns (energy, RIndex, cos and sin of theta, cos
+   and sin of phi and the fraction of the step where a photon is emitted).
+   No G4 objects are created, so this stage can be profiled (and
+   vectorized) on its own
+2. G4ChRPhotonBatch::MaterializePhotons - creates G4DynamicParticle and
+   G4Track objects from the columns and adds them to the particle change;
+   momentum and polarization columns are built first, for all photons, by
+   vectorized kernels (see G4ChRPhotonKernels.hh)
+
+Between the stages, models can modify the columns, e.g.,
+G4ThinTargetChR_Model smears theta of each photon, and angular biasing (see
+G4ChRAngularBiasing.hh) moves phi of each photon into the acceptance window
+(BiasPhi) and removes photons outside of it (ApplyAcceptance). With forced
+emission (see G4ChRForcedEmission.hh), FindTargetCones finds the cone of
+each photon towards the target (cone columns), and BiasPhiToTargetCones
+moves phi of each photon into its cone. Removed photons are compacted out
+of the columns, so m_noOfPhotons can decrease. With biasing, each photon
+has its own weight factor (m_weight).
+
+G4ChREnergySampler is prepared once per step (see
+G4BaseChR_Model::PrepareEnergySampler) and it selects how photon energies
+are sampled:
+1. AboveThreshold - inverting the big-beta columns above the threshold
+                    energy (no photon is rejected)
+2. AliasTable     - alias tables of the upper beta node (exotic RIndex)
+3. CDF            - inverse CDF of the upper beta node (exotic RIndex)
+4. Uniform        - uniform energies with rejection (tables without CDFs)
+
+Note that the random numbers are not drawn in the same order as in the
+previous (photon-by-photon) loop - first all energies, then all phi angles
+and then all step fractions - so the same seed gives different (but
+statistically equivalent) photons. All numbers of a step (including
+Gaussian numbers of models between the stages) are taken from
+m_randomBuffer (see G4ChRRandomBuffer.hh), which is cleared at the end of
+MaterializePhotons.
+In the counter-based mode of the buffer (see G4ChRRandomBuffer.hh), each
+photon has its own stream (m_streamID, its index in Generate), so its
+numbers don't depend on other photons: draw 0 is phi, draw 1 is the step
+fraction, energies start at draw 2 and numbers of models between the stages
+start at m_firstModelDraw (see SelectPhotonStream). The only exception is
+the Uniform sampler with m_adaptMinEnergy, whose minimum energy is raised by
+rejected energies of previous photons.
+
+With weighted photon thinning (see G4ExtraOpticalParameters.hh), models
+sample a k times smaller number of photons and MaterializePhotons gives each
+photon the weight k (times the weight of the parent track). Secondary
+weights are then set by the process, i.e., the particle change must have
+SetSecondaryWeightByProcess(true).
+
+Columns are never shrunk, so a batch that is a member of a model/process
+(each thread has its own) doesn't allocate after the first few steps.
+*/
+
+#pragma once
+#ifndef G4ChRPhotonBatch_hh
+#define G4ChRPhotonBatch_hh
+
+//G4 headers
+#include "globals.hh"
+#include "G4PhysicsFreeVector.hh"
+#include "G4ChRPhysicsTableData.hh"
+#include "G4ChRPhotonKernels.hh"
+#include "G4ChRRandomBuffer.hh"
+#include "G4ChRAngularBiasing.hh"
+#include "G4ChRForcedEmission.hh"
+//std:: headers
+#include <vector>
+#include <cstdint>
+
+class G4Track;
+class G4Step;
+class G4ParticleChange;
+
+enum class G4ChREnergySamplingMode : unsigned char {
+	AboveThreshold,
+	AliasTable,
+	CDF,
+	Uniform
+};
+
+struct G4ChREnergySampler {
+	const G4ChRPhysTableData* p_physData = nullptr;
+	const G4PhysicsFreeVector* p_RIndex = nullptr;
+	const G4ChRTableValue* p_CDFRow = nullptr; // CDF mode
+	G4double m_beta = 0.;
+	G4double m_thresholdEnergy = 0.; // AboveThreshold mode
+	// Uniform mode; m_minEnergy is raised by rejected energies if m_adaptMinEnergy
+	G4double m_minEnergy = 0.;
+	G4double m_maxEnergy = 0.;
+	size_t m_betaID = 0; // AliasTable mode
+	G4ChREnergySamplingMode m_mode = G4ChREnergySamplingMode::Uniform;
+	G4bool m_adaptMinEnergy = false;
+
+	// returns the energy and sets its RIndex and cos(theta); rejects energies with cos(theta) >= 1
+	G4double SampleEnergy(G4ChRRandomBuffer& aRandomBuffer, G4double& sampledRI, G4double& cosTheta);
+};
+
+struct G4ChRPhotonBatch {
+	void Resize(const size_t noOfPhotons);
+	// stage 1 - samples noOfPhotons photons into the columns
+	void Generate(G4ChREnergySampler& aSampler, const size_t noOfPhotons);
+	// momentum (and polarization) columns from theta and phi columns, rotated with aFrame
+	void BuildDirections(const G4ChRRotationFrame& aFrame, const G4bool withPolarization);
+	// angular biasing; primaryFrame is G4ChRRotationFrame::FromDirection(p0)
+	// phi of all photons is moved into the phi window (or the interval inside the global cone), and weights are set
+	// with useConeMargins, the global cone of each photon is wider by its m_coneMargin (e.g., smearing after biasing)
+	void BiasPhi(const G4ChRAngularBiasing& aBiasing, const G4ChRRotationFrame& primaryFrame, const G4bool useConeMargins = false);
+	// forced emission; x0 and deltaPosition of the step
+	// finds the cone of each photon (photons that cannot reach the target are removed), and margins are set to 0
+	void FindTargetCones(const G4ChRForcedEmission& aForcedEmission, const G4ChRExitPlane& anExitPlane,
+		const G4ThreeVector& x0, const G4ThreeVector& deltaPosition);
+	// phi of all photons is moved into the interval inside their cones (widened by m_coneMargin), and weights are set
+	void BiasPhiToTargetCones(const G4ChRRotationFrame& primaryFrame);
+	// removes photons outside the theta window (or the global cone) and outside their target cones (if found)
+	// aBiasing can be nullptr (only target cones)
+	void ApplyAcceptance(const G4ChRAngularBiasing* aBiasing, const G4ChRRotationFrame& primaryFrame);
+	// stage 2 - adds a secondary track for each photon; returns the sum of energies of all photons sampled by Generate
+	// (times thinningFactor), i.e., the energy loss of the primary doesn't depend on biasing
+	G4double MaterializePhotons(const G4Track& aTrack, const G4Step& aStep, G4ParticleChange* aParticleChange,
+		const unsigned short thinningFactor = 1);
+	// counter-based mode - numbers of m_randomBuffer are taken from the stream of photon i; nothing is done otherwise
+	inline void SelectPhotonStream(const size_t i, const std::uint32_t firstDraw = m_firstModelDraw);
+
+	// the first draw of a photon stream that is not used by Generate
+	static constexpr std::uint32_t m_firstModelDraw = 1u << 30;
+
+	//=======Columns=======
+	std::vector<G4double> m_energy;
+	std::vector<G4double> m_RIndex;
+	std::vector<G4double> m_cosTheta;
+	std::vector<G4double> m_sinTheta;
+	std::vector<G4double> m_phi;
+	std::vector<G4double> m_cosPhi;
+	std::vector<G4double> m_sinPhi;
+	std::vector<G4double> m_stepFraction; // [0, 1) - position (and time) along the step
+	std::vector<G4double> m_weight; // only if m_isWeighted (set by BiasPhi)
+	std::vector<std::uint32_t> m_streamID; // only in counter-based mode
+	// only if m_hasTargetCones (set by FindTargetCones); the axis is global
+	std::vector<G4double> m_coneAxisX;
+	std::vector<G4double> m_coneAxisY;
+	std::vector<G4double> m_coneAxisZ;
+	std::vector<G4double> m_coneHalfAngle;
+	std::vector<G4double> m_coneMargin; // the cone is wider by the margin when phi is sampled (also the global cone of BiasPhi)
+	// filled by BuildDirections
+	std::vector<G4double> m_momentumX;
+	std::vector<G4double> m_momentumY;
+	std::vector<G4double> m_momentumZ;
+	std::vector<G4double> m_polarizationX;
+	std::vector<G4double> m_polarizationY;
+	std::vector<G4double> m_polarizationZ;
+	size_t m_noOfPhotons = 0;
+	G4double m_generatedEnergy = 0.; // of all photons sampled by Generate (before any photon is removed)
+	G4ChRRandomBuffer m_randomBuffer;
+	G4bool m_isWeighted = false;
+	G4bool m_hasTargetCones = false;
+
+private:
+	// copies the sampled columns of photon 'from' to photon 'to' (compaction)
+	inline void MovePhoton(const size_t from, const size_t to);
+	void ComputePhiColumns();
+	// Generate in counter-based mode (see G4ChRRandomBuffer.hh)
+	void GenerateCounterBased(G4ChREnergySampler& aSampler, const size_t noOfPhotons);
+	// the half-width of the phi interval in which (theta, phi) is inside the cone around the axis (theta, phiAxis);
+	// 0 if theta never reaches the cone
+	[[nodiscard]] static G4double FindPhiHalfWidth(const G4double sinTheta, const G4double cosTheta,
+		const G4double sinThetaAxis, const G4double cosThetaAxis, const G4double cosAlpha);
+};
+
+//=======Additional inlines=======
+void G4ChRPhotonBatch::MovePhoton(const size_t from, const size_t to) {
+	if (from == to)
+		return;
+	m_energy[to] = m_energy[from];
+	m_RIndex[to] = m_RIndex[from];
+	m_cosTheta[to] = m_cosTheta[from];
+	m_sinTheta[to] = m_sinTheta[from];
+	m_phi[to] = m_phi[from];
+	m_cosPhi[to] = m_cosPhi[from];
+	m_sinPhi[to] = m_sinPhi[from];
+	m_stepFraction[to] = m_stepFraction[from];
+	m_weight[to] = m_weight[from];
+	if (m_randomBuffer.IsCounterBased())
+		m_streamID[to] = m_streamID[from];
+	if (!m_hasTargetCones)
+		return;
+	m_coneAxisX[to] = m_coneAxisX[from];
+	m_coneAxisY[to] = m_coneAxisY[from];
+	m_coneAxisZ[to] = m_coneAxisZ[from];
+	m_coneHalfAngle[to] = m_coneHalfAngle[from];
+	m_coneMargin[to] = m_coneMargin[from];
+}
+
+void G4ChRPhotonBatch::SelectPhotonStream(const size_t i, const std::uint32_t firstDraw) {
+	if (m_randomBuffer.IsCounterBased())
+		m_randomBuffer.SelectStream(m_streamID[i], firstDraw);
+}
+
+#endif // !G4ChRPhotonBatch_hh
\ No newline at end of file
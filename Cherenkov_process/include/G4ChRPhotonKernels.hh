@@ -0,0 +1,119 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+/*
+ABOUT THE HEADER
+----------------
+
+Kernels that build Cherenkov photon momentum and polarization directions
+for whole G4ChRPhotonBatch columns, instead of two
+G4ThreeVector::rotateUz(p0) calls per photon.
+
+G4ChRRotationFrame is the matrix of G4ThreeVector::rotateUz(p0). It is
+built once per step (FromDirection), and it can be combined with another
+axis transformation (e.g., G4ThinTargetChR_Model takes momenta to the local
+system of the volume with a single frame instead of rotateUz followed by
+G4AffineTransform::ApplyAxisTransform).
+
+Momentum and polarization in the frame where p0 is the z axis are:
+momentum     = (sinTheta * cosPhi, sinTheta * sinPhi, cosTheta)
+polarization = (cosTheta * cosPhi, cosTheta * sinPhi, -sinTheta)
+
+The vectorized path is selected at compile time:
+1. AVX2 - if the compiler targets AVX2 (__AVX2__, e.g., -mavx2 or
+          /arch:AVX2; see the USE_AVX2_CHR_KERNELS CMake option), 4 photons
+          per instruction
+2. SSE2 - x86-64 (SSE2 is always available), 2 photons per instruction
+3. scalar fallback - other architectures or if G4ChR_NO_SIMD is defined
+The scalar kernels are always compiled (...Scalar) so both paths can be
+compared. All paths do the same multiplications and additions in the same
+order (no FMA intrinsics), so vectorized results equal the scalar ones
+bit by bit unless the compiler contracts the scalar code into FMAs (e.g.,
+-mfma); then, components differ by at most DBL_EPSILON.
+
+Tolerance relative to G4ThreeVector::rotateUz: rotateUz divides by
+sqrt(ux^2 + uy^2) for each vector, while the frame divides once, so
+components (all within [-1, 1]) differ by at most 4 * DBL_EPSILON
+(G4ChRRotationFrame::m_rotateUzTolerance; 1.5 * DBL_EPSILON was the
+largest difference found for 2 million random photons and directions,
+including p0 = (0, 0, +-1)). That is far below the
+precision of anything optical photons are used for.
+*/
+
+#pragma once
+#ifndef G4ChRPhotonKernels_hh
+#define G4ChRPhotonKernels_hh
+
+//G4 headers
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+//std:: headers
+#include <cfloat>
+
+class G4AffineTransform;
+
+struct G4ChRRotationFrame {
+	static constexpr G4double m_rotateUzTolerance = 4. * DBL_EPSILON;
+
+	// the same rotation as G4ThreeVector::rotateUz(p0); p0 must be a unit vector
+	[[nodiscard]] static G4ChRRotationFrame FromDirection(const G4ThreeVector& p0);
+	// this frame followed by G4AffineTransform::ApplyAxisTransform
+	[[nodiscard]] G4ChRRotationFrame Transformed(const G4AffineTransform& aTransform) const;
+	[[nodiscard]] inline G4ThreeVector Apply(const G4ThreeVector& aVector) const;
+	// the inverse rotation (the transposed matrix), i.e., from global to the frame
+	[[nodiscard]] inline G4ThreeVector ApplyInverse(const G4ThreeVector& aVector) const;
+
+	// row-major 3x3 matrix
+	G4double m_matrix[9] = { 1., 0., 0., 0., 1., 0., 0., 0., 1. };
+};
+
+// columns of a batch as G4ThreeVector components (SoA)
+struct G4ChRDirectionColumns {
+	G4double* p_x = nullptr;
+	G4double* p_y = nullptr;
+	G4double* p_z = nullptr;
+};
+
+class G4ChRPhotonKernels final {
+public:
+	G4ChRPhotonKernels() = delete;
+
+	// sinTheta = sqrt((1 - cosTheta) * (1 + cosTheta))
+	static void ComputeSinTheta(const G4double* cosTheta, G4double* sinTheta, const size_t noOfPhotons);
+	static void ComputeSinThetaScalar(const G4double* cosTheta, G4double* sinTheta, const size_t noOfPhotons);
+
+	// momenta (and polarizations if polarization.p_x is not nullptr) rotated with aFrame
+	static void BuildDirections(const G4ChRRotationFrame& aFrame, const G4double* cosTheta, const G4double* sinTheta,
+		const G4double* cosPhi, const G4double* sinPhi, const size_t noOfPhotons,
+		G4ChRDirectionColumns momentum, G4ChRDirectionColumns polarization);
+	static void BuildDirectionsScalar(const G4ChRRotationFrame& aFrame, const G4double* cosTheta, const G4double* sinTheta,
+		const G4double* cosPhi, const G4double* sinPhi, const size_t noOfPhotons,
+		G4ChRDirectionColumns momentum, G4ChRDirectionColumns polarization);
+
+	// "AVX2", "SSE2" or "scalar"
+	[[nodiscard]] static const char* GetInstructionSetName();
+};
+
+//=======Additional inlines=======
+G4ThreeVector G4ChRRotationFrame::Apply(const G4ThreeVector& aVector) const {
+	const G4double* M = m_matrix;
+	return G4ThreeVector{
+		M[0] * aVector.x() + M[1] * aVector.y() + M[2] * aVector.z(),
+		M[3] * aVector.x() + M[4] * aVector.y() + M[5] * aVector.z(),
+		M[6] * aVector.x() + M[7] * aVector.y() + M[8] * aVector.z() };
+}
+
+G4ThreeVector G4ChRRotationFrame::ApplyInverse(const G4ThreeVector& aVector) const {
+	const G4double* M = m_matrix;
+	return G4ThreeVector{
+		M[0] * aVector.x() + M[3] * aVector.y() + M[6] * aVector.z(),
+		M[1] * aVector.x() + M[4] * aVector.y() + M[7] * aVector.z(),
+		M[2] * aVector.x() + M[5] * aVector.y() + M[8] * aVector.z() };
+}
+
+#endif // !G4ChRPhotonKernels_hh
\ No newline at end of file
@@ -0,0 +1,67 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+/*
+ABOUT THE HEADER
+----------------
+
+G4ChRPhotonPool is an optional (per-thread) allocation strategy for
+optical photons of Cherenkov models and G4StandardCherenkovProcess. Each
+photon is a G4DynamicParticle and a G4Track, and both are deleted by
+Geant4 (tracking/stacking managers), i.e., through their G4Allocator
+pools. Therefore, they cannot be placed into a private arena, but the
+G4Allocator pools are already per-thread free lists, so the strategy
+tunes them:
+1. Enable(pageFactor) - pages of the G4Track and G4DynamicParticle pools
+   are pageFactor times larger, so photon-heavy events call malloc
+   pageFactor times less often; memory of deleted photons returns to the
+   free list and it's reused by the next steps/events
+2. Disable - secondary lists are not reserved any more; pool pages keep
+   their size, and their storage is left to Geant4 (the allocators are
+   shared with the kernel and other users on the thread)
+3. SetNumberOfSecondaries - used instead of
+   G4ParticleChange::SetNumberOfSecondaries; with the pool, the secondary
+   list is reserved for the largest number of photons of a step in the
+   current event, so it's never regrown within an event (the high-water
+   mark is reset when a new event starts)
+
+Changing the page size of a G4Allocator releases all of its storage, so
+Enable must be called when no G4Track exists on the thread, i.e., between
+runs. That's the case for the UI command
+(/process/optical/G4ChRProcess/Models/usePhotonPool), which is broadcast to
+workers and executed before their next run. G4DynamicParticle objects can
+outlive runs (some Geant4 classes keep their own), so that pool is changed
+only if it has no pages yet. The pool memory is not released at the end of
+each event - tracks postponed to the next event may still be alive then,
+and the pages would be allocated again anyway.
+The page size cannot be decreased, so Enable changes it only once per
+thread.
+*/
+
+#pragma once
+#ifndef G4ChRPhotonPool_hh
+#define G4ChRPhotonPool_hh
+
+//G4 headers
+#include "globals.hh"
+
+class G4ParticleChange;
+
+class G4ChRPhotonPool final {
+public:
+	G4ChRPhotonPool() = delete;
+
+	// for the calling thread; no G4Track may exist (see above)
+	static void Enable(const unsigned int pageFactor, const unsigned char verboseLevel = 0);
+	static void Disable();
+	[[nodiscard]] static G4bool IsEnabled();
+
+	static void SetNumberOfSecondaries(G4ParticleChange* aParticleChange, const G4int noOfPhotons);
+};
+
+#endif // !G4ChRPhotonPool_hh
\ No newline at end of file
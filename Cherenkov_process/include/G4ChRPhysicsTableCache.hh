@@ -0,0 +1,100 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+/*
+ABOUT THE HEADER
+----------------
+
+G4ChRPhysicsTableCache is a static helper class that stores/retrieves
+Cherenkov physics tables (G4ChRPhysTableData) into/from a binary file. It
+is used by G4ChRPhysicsTableService::Store/RetrievePhysicsTables, i.e.,
+through the /run/particle/storePhysicsTable and
+/run/particle/retrievePhysicsTable UI commands (both G4CherenkovProcess
+models and G4StandardCherenkovProcess forward them to the service).
+
+Each material table is identified by a key - a 64-bit FNV-1a hash of the
+RINDEX energy and value vectors, the number of beta steps, the adaptive
+beta-grid tolerance, the integration mode (with exact integration, RINDEX
+second derivatives are hashed as well) and the exotic RIndex flag. When retrieving, tables are found by their key and not by the
+material index, so adding/reordering materials doesn't invalidate the
+file. Tables of materials that are not found in the file are rebuilt.
+The same keys are used to share tables between materials with the same
+RINDEX (see G4ChRPhysicsTableVector), and a shared table is written only
+once (index entries of such materials have the same arena offset).
+
+The file format (version 2) uses only 8-byte fields, so all arenas are
+8-byte aligned and the file can be memory-mapped as is:
+1. header - magic "G4ChRTab", format version, number of tables,
+            number of beta steps, size of G4ChRTableValue (4 or 8)
+2. index  - for each table: key, noOfBetaNodes, noOfEnergyNodes and the
+            offset of the table (in bytes from the beginning of the file)
+3. tables - for each table, the G4ChRPhysTableData axis arena followed by
+            the value arena (zero-padded to a multiple of 8 bytes)
+Files with a different G4ChRTableValue (i.e., written by a library built
+with(out) G4ChR_USE_FLOAT_TABLES) are rejected and the tables rebuilt.
+
+Values are written in the native byte order, so files should not be shared
+between machines with different endianness (the magic value would not
+match anyway, so the file would be rejected and the tables rebuilt).
+The 'ascii' flag of Geant4 is ignored - the binary format is always used.
+*/
+
+#pragma once
+#ifndef G4ChRPhysicsTableCache_hh
+#define G4ChRPhysicsTableCache_hh
+
+//G4 headers
+#include "globals.hh"
+#include "G4ChRPhysicsTableVector.hh"
+//std:: headers
+#include <vector>
+#include <cstdint>
+#include <istream>
+
+class G4ChRPhysicsTableCache final {
+public:
+	// materialID -> is the exotic RIndex table needed
+	using G4ChRExoticFlagFunction = G4bool(*)(const size_t);
+	using G4ChRBuildTableFunction = G4ChRPhysicsTableVector::G4ChRBuildTableFunction;
+	// prepares data that is not stored (e.g., alias tables) of a retrieved table; materialID is one of the materials with the table
+	using G4ChRFinishTableFunction = void(*)(const size_t, G4ChRPhysTableData&);
+
+	G4ChRPhysicsTableCache() = delete;
+
+	[[nodiscard]] static G4String GetCacheFileName(const G4String& directory, const G4String& ownerName);
+	[[nodiscard]] static std::uint64_t GetMaterialTableKey(const size_t materialID, const unsigned int noOfBetaSteps,
+		const G4double betaGridTolerance, const G4bool exactIntegration, const G4bool exoticFlag);
+	// keys of all registered materials, in material-index order
+	[[nodiscard]] static std::vector<std::uint64_t> GetMaterialTableKeys(const unsigned int noOfBetaSteps, const G4double betaGridTolerance,
+		const G4bool exactIntegration, G4ChRExoticFlagFunction anExoticFlagFunction);
+	// the file is not rewritten if it already holds tables with the same keys
+	static G4bool StoreTables(const G4String& fileName, const G4ChRPhysicsTableVector& physDataVec,
+		const unsigned int noOfBetaSteps, const G4double betaGridTolerance, const G4bool exactIntegration, G4ChRExoticFlagFunction anExoticFlagFunction);
+	// returns false if the file cannot be used (missing, different version or corrupted), so Geant4 can build the tables
+	// otherwise, tables not found in the file are built with aBuildFunction (on the task pool)
+	static G4bool RetrieveTables(const G4String& fileName, G4ChRPhysicsTableVector& physDataVec, const unsigned int noOfBetaSteps,
+		const G4double betaGridTolerance, const G4bool exactIntegration, G4ChRExoticFlagFunction anExoticFlagFunction, G4ChRBuildTableFunction aBuildFunction,
+		size_t& noOfRebuiltTables,
+		G4ChRFinishTableFunction aFinishFunction = nullptr);
+private:
+	static constexpr std::uint64_t m_formatVersion = 2;
+	static constexpr char m_magic[8] = { 'G', '4', 'C', 'h', 'R', 'T', 'a', 'b' };
+
+	struct G4ChRCacheIndexEntry {
+		std::uint64_t m_key = 0;
+		std::uint64_t m_noOfBetaNodes = 0;
+		std::uint64_t m_noOfEnergyNodes = 0;
+		std::uint64_t m_offset = 0;
+	};
+
+	static G4bool ReadIndex(std::istream& inStream, std::vector<G4ChRCacheIndexEntry>& indexVec, const unsigned int noOfBetaSteps);
+	// in bytes, with the padding of the value arena
+	[[nodiscard]] static std::uint64_t GetStoredTableSize(const std::uint64_t noOfBetaNodes, const std::uint64_t noOfEnergyNodes);
+};
+
+#endif // !G4ChRPhysicsTableCache_hh
\ No newline at end of file
@@ -6,6 +6,61 @@
 //####### Contact: zobla96@gmail.com #######
 //##########################################
 
+/*
+ABOUT THE HEADER
+----------------
+
+G4ChRPhysTableData keeps all Cherenkov physics-table values of a single
+material in two contiguous arenas. Both are organized as a structure of
+arrays, i.e., columns that follow each other. The axis arena (G4double)
+holds the values that are compared with beta and energy of particles:
+
+1. beta values           [noOfBetaNodes]
+2. energy axis           [noOfEnergyNodes] (shared by all CDF rows)
+while the value arena (G4ChRTableValue) holds the sampled quantities:
+3. left integrals (dE)   [noOfBetaNodes]
+4. right integrals       [noOfBetaNodes] (dE / RIndex^2)
+5. CDF rows              [noOfBetaNodes * noOfEnergyNodes] (row-major, values in [0, 1])
+6. big-beta left column  [noOfEnergyNodes] (cumulative dE for betaMax)
+7. big-beta right column [noOfEnergyNodes] (cumulative dE / RIndex^2 for betaMax)
+The energy axis and columns 5-7 exist only if CDF tables are built
+(noOfEnergyNodes > 0). The big-beta columns do not depend on beta, so for a
+RIndex that increases with energy they also give the CDF of any beta above
+its threshold energy (SampleEnergyAboveThreshold).
+
+G4ChRTableValue is G4double, or float if the library is built with
+G4ChR_USE_FLOAT_TABLES (the USE_FLOAT_CHR_TABLES CMake option). Float
+tables take half the memory (CDF rows are most of it) and twice as many
+values fit into a cache line. Tables are always integrated in double and
+rounded when stored, and all sampling methods read stored values as
+G4double, so only the rounding (~6e-8 relative) is added. Near the
+threshold, the photon yield and the big-beta CDFs are differences of
+close values, so the rounding error there is relative to the yield at
+betaMax (see G4ChRPhysicsTableService::ValidatePhysicsTables).
+
+The previous version kept a heap-allocated vector for every CDF and
+another one for big-beta values (with the energy axis repeated each
+time). With the arena, everything the photon loop reads is in one block.
+Once built, the tables should be treated as read-only.
+
+Beta nodes are built with a constant step, so the grid origin and inverse
+spacing are kept as well (UpdateBetaGridLookup), and FindUpperBetaNode
+calculates the node directly instead of using a binary search. If the grid
+is not uniform, the binary search is used.
+
+Optionally (BuildAliasTables), Walker/Vose alias tables are kept for every
+CDF row outside of the arena. A CDF row with linear interpolation between
+energy nodes is a piecewise-constant density, so an energy interval is
+selected through the alias table and the energy is sampled uniformly in
+that interval - the same distribution as SampleEnergyFromCDF in O(1).
+
+Optionally (SetUniformRIndexGrid), RIndex is resampled onto a uniform energy
+grid outside of the arena as well. G4PhysicsVector::Value searches for the
+bin of a non-uniform grid, while GetRIndexValue calculates the bin directly.
+The grid is linearly interpolated, so its error (kept with the grid) depends
+on the number of grid nodes and the curvature of RIndex.
+*/
+
 #pragma once
 #ifndef G4ChRPhysicsTableData_hh
 #define G4ChRPhysicsTableData_hh
@@ -15,48 +70,408 @@
 #include "G4ThreeVector.hh"
 //std:: headers
 #include <vector>
-#include <utility>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 
-struct G4ChRPhysTableData {
-	struct G4AroundBetaBasedValues;
-	// going twice with std::vector<...>* as it should take less memory in most of applications, i.e.,
-	// mostly CDF values are not needed! A vector itself is 24 bytes.
-	std::vector<G4AroundBetaBasedValues> m_aroundBetaValues;
-	std::vector<G4ThreeVector>* p_bigBetaCDFVector = nullptr; // leftInt and rightInt values for CDF, but beta is not included yet
-	//used only for maxBeta
-
-	struct G4AroundBetaBasedValues {
-		G4AroundBetaBasedValues(G4double beta, G4double leftInt, G4double rightInt)
-		 : m_betaValue(beta), m_leftIntegralValue(leftInt), m_rightIntegralValue(rightInt) {}
-		~G4AroundBetaBasedValues() {
-			delete p_valuesCDF;
-		}
-		G4double m_betaValue;
-		G4double m_leftIntegralValue;
-		G4double m_rightIntegralValue;
-		std::vector<std::pair<G4double, G4double>>* p_valuesCDF = nullptr; // real cdf values in range [0, 1]
-	};
+#ifdef G4ChR_USE_FLOAT_TABLES
+using G4ChRTableValue = float;
+#else
+using G4ChRTableValue = G4double;
+#endif
 
+struct G4ChRPhysTableData {
 	G4ChRPhysTableData() = default;
-	~G4ChRPhysTableData() {
-		delete p_bigBetaCDFVector;
-	}
+	~G4ChRPhysTableData() = default;
 
 	G4ChRPhysTableData& operator=(const G4ChRPhysTableData& other) = delete;
 	G4ChRPhysTableData(const G4ChRPhysTableData& other) = delete;
+	G4ChRPhysTableData& operator=(G4ChRPhysTableData&& other) noexcept = default;
+	G4ChRPhysTableData(G4ChRPhysTableData&& other) noexcept = default;
 
-	G4ChRPhysTableData& operator=(G4ChRPhysTableData&& other) noexcept {
-		if (this == &other)
-			return *this;
-		m_aroundBetaValues = std::exchange(other.m_aroundBetaValues, std::vector<G4AroundBetaBasedValues>{});
-		delete p_bigBetaCDFVector;
-		p_bigBetaCDFVector = std::exchange(other.p_bigBetaCDFVector, nullptr);
-		return *this;
-	}
+	//=======Builder inlines=======
+	// noOfEnergyNodes == 0 -> only standard (beta, leftInt, rightInt) columns are allocated
+	inline void AllocateTables(const size_t noOfBetaNodes, const size_t noOfEnergyNodes = 0);
+	// a new table with the standard columns only, i.e., without exotic RIndex columns (energy axis, CDFs and big-beta
+	// columns) and alias tables. Built tables might be shared between materials, so they are not modified in place
+	[[nodiscard]] inline G4ChRPhysTableData CopyWithoutCDFTables() const;
+	inline void SetBetaNode(const size_t betaID, const G4double beta, const G4double leftInt, const G4double rightInt);
+	[[nodiscard]] inline G4double* GetEnergyColumnToFill();
+	[[nodiscard]] inline G4ChRTableValue* GetCDFRowToFill(const size_t betaID);
+	[[nodiscard]] inline G4ChRTableValue* GetBigBetaLeftColumnToFill();
+	[[nodiscard]] inline G4ChRTableValue* GetBigBetaRightColumnToFill();
+	// must be called after all beta nodes are set - enables the direct (O(1)) beta-node lookup for uniform grids
+	inline void UpdateBetaGridLookup();
+	// builds alias tables for all CDF rows (if CDF tables exist), must be called after the CDF rows are filled
+	inline void BuildAliasTables();
+	// RIndexValues are RIndex values at uniformly spaced energies from minEnergy to maxEnergy (at least 2 nodes)
+	inline void SetUniformRIndexGrid(const G4double minEnergy, const G4double maxEnergy, std::vector<G4double>&& RIndexValues);
+	// the max. absolute error of the resampled RIndex, only for printing
+	inline void SetRIndexGridError(const G4double maxError);
+	// the whole arenas, e.g., to read tables from a file after AllocateTables
+	[[nodiscard]] inline G4double* GetAxisArenaToFill();
+	[[nodiscard]] inline G4ChRTableValue* GetValueArenaToFill();
 
-	G4ChRPhysTableData(G4ChRPhysTableData&& other) noexcept
-	: m_aroundBetaValues(std::exchange(other.m_aroundBetaValues, std::vector<G4AroundBetaBasedValues>{})),
-	p_bigBetaCDFVector(std::exchange(other.p_bigBetaCDFVector, nullptr)) {}
+	//=======Get inlines=======
+	[[nodiscard]] inline size_t GetNoOfBetaNodes() const;
+	[[nodiscard]] inline size_t GetNoOfEnergyNodes() const;
+	[[nodiscard]] inline G4bool HasCDFTables() const;
+	[[nodiscard]] inline size_t GetArenaSizeInBytes() const;
+	[[nodiscard]] inline size_t GetAxisArenaSize() const;
+	[[nodiscard]] inline size_t GetValueArenaSize() const;
+	[[nodiscard]] inline const G4double* GetAxisArena() const;
+	[[nodiscard]] inline const G4ChRTableValue* GetValueArena() const;
+	[[nodiscard]] inline G4double GetBetaValue(const size_t betaID) const;
+	[[nodiscard]] inline G4double GetLeftIntegral(const size_t betaID) const;
+	[[nodiscard]] inline G4double GetRightIntegral(const size_t betaID) const;
+	[[nodiscard]] inline G4double GetFrontBeta() const;
+	[[nodiscard]] inline G4double GetBackBeta() const;
+	[[nodiscard]] inline const G4double* GetBetaColumn() const;
+	[[nodiscard]] inline const G4ChRTableValue* GetLeftIntegralColumn() const;
+	[[nodiscard]] inline const G4ChRTableValue* GetRightIntegralColumn() const;
+	[[nodiscard]] inline const G4double* GetEnergyColumn() const;
+	[[nodiscard]] inline const G4ChRTableValue* GetCDFRow(const size_t betaID) const;
+	[[nodiscard]] inline const G4ChRTableValue* GetBigBetaLeftColumn() const;
+	[[nodiscard]] inline const G4ChRTableValue* GetBigBetaRightColumn() const;
+	[[nodiscard]] inline G4bool HasUniformBetaGrid() const;
+	[[nodiscard]] inline G4bool HasAliasTables() const;
+	[[nodiscard]] inline G4bool HasUniformRIndexGrid() const;
+	[[nodiscard]] inline size_t GetNoOfRIndexGridNodes() const;
+	[[nodiscard]] inline G4double GetRIndexGridError() const;
+
+	//=======Additional inlines=======
+	// returns the ID of the first beta node with a value >= betaValue (never 0 nor out of range)
+	[[nodiscard]] inline size_t FindUpperBetaNode(const G4double betaValue) const;
+	// inverts a CDF row (any column of noOfEnergyNodes values in [0, 1]) for a random number
+	[[nodiscard]] inline G4double SampleEnergyFromCDF(const G4ChRTableValue* cdfRow, const G4double rand) const;
+	// for beta > betaMax of exotic tables: inverts CDF(E) = (left(E) - right(E) / beta^2) / norm directly on the
+	// big-beta columns, i.e., without building (and normalizing) a temporary CDF row
+	[[nodiscard]] inline G4double SampleEnergyForBigBeta(const G4double beta, const G4double rand) const;
+	// the same inversion on the big-beta columns, but only above thresholdEnergy (where beta * RIndex(E) = 1). It is
+	// valid for any beta > betaMin if RIndex increases with energy (no photons below and all energies above the threshold)
+	[[nodiscard]] inline G4double SampleEnergyAboveThreshold(const G4double beta, const G4double thresholdEnergy, const G4double rand) const;
+	// O(1) alternative to SampleEnergyFromCDF(GetCDFRow(betaID), ...) - requires BuildAliasTables
+	[[nodiscard]] inline G4double SampleEnergyFromAliasTable(const size_t betaID, const G4double rand1, const G4double rand2) const;
+	// O(1) alternative to RIndex->Value(energy) - requires SetUniformRIndexGrid; clamped to the grid as G4PhysicsVector::Value
+	[[nodiscard]] inline G4double GetRIndexValue(const G4double energy) const;
+private:
+	std::vector<G4double> m_axisArena;
+	std::vector<G4ChRTableValue> m_valueArena;
+	size_t m_noOfBetaNodes = 0;
+	size_t m_noOfEnergyNodes = 0;
+	G4double m_betaOrigin = 0.;
+	G4double m_invDeltaBeta = 0.; // 0. -> non-uniform grid (or not enough nodes), binary search is used
+	// alias tables - (noOfEnergyNodes - 1) intervals for each beta node
+	std::vector<G4double> m_aliasProbabilities;
+	std::vector<std::uint32_t> m_aliasIndices;
+	// uniform RIndex grid
+	std::vector<G4double> m_RIndexGrid;
+	G4double m_RIndexGridOrigin = 0.;
+	G4double m_invDeltaRIndexEnergy = 0.;
+	G4double m_RIndexGridError = 0.;
 };
 
+//=======Builder inlines=======
+
+void G4ChRPhysTableData::AllocateTables(const size_t noOfBetaNodes, const size_t noOfEnergyNodes) {
+	m_noOfBetaNodes = noOfBetaNodes;
+	m_noOfEnergyNodes = noOfEnergyNodes;
+	m_betaOrigin = 0.;
+	m_invDeltaBeta = 0.;
+	m_aliasProbabilities.clear();
+	m_aliasIndices.clear();
+	m_RIndexGrid.clear();
+	m_RIndexGridError = 0.;
+	std::vector<G4double>(noOfBetaNodes + noOfEnergyNodes, 0.).swap(m_axisArena);
+	std::vector<G4ChRTableValue>(2 * noOfBetaNodes + noOfEnergyNodes * (noOfBetaNodes + 2), 0.).swap(m_valueArena);
+}
+
+G4ChRPhysTableData G4ChRPhysTableData::CopyWithoutCDFTables() const {
+	G4ChRPhysTableData standardTables{};
+	standardTables.AllocateTables(m_noOfBetaNodes);
+	std::copy(m_axisArena.begin(), m_axisArena.begin() + m_noOfBetaNodes, standardTables.m_axisArena.begin());
+	std::copy(m_valueArena.begin(), m_valueArena.begin() + 2 * m_noOfBetaNodes, standardTables.m_valueArena.begin());
+	standardTables.m_betaOrigin = m_betaOrigin;
+	standardTables.m_invDeltaBeta = m_invDeltaBeta;
+	standardTables.m_RIndexGrid = m_RIndexGrid;
+	standardTables.m_RIndexGridOrigin = m_RIndexGridOrigin;
+	standardTables.m_invDeltaRIndexEnergy = m_invDeltaRIndexEnergy;
+	standardTables.m_RIndexGridError = m_RIndexGridError;
+	return standardTables;
+}
+
+void G4ChRPhysTableData::SetBetaNode(const size_t betaID, const G4double beta, const G4double leftInt, const G4double rightInt) {
+	m_axisArena[betaID] = beta;
+	m_valueArena[betaID] = static_cast<G4ChRTableValue>(leftInt);
+	m_valueArena[m_noOfBetaNodes + betaID] = static_cast<G4ChRTableValue>(rightInt);
+}
+
+G4double* G4ChRPhysTableData::GetEnergyColumnToFill() {
+	return m_axisArena.data() + m_noOfBetaNodes;
+}
+
+G4ChRTableValue* G4ChRPhysTableData::GetCDFRowToFill(const size_t betaID) {
+	return m_valueArena.data() + 2 * m_noOfBetaNodes + betaID * m_noOfEnergyNodes;
+}
+
+G4ChRTableValue* G4ChRPhysTableData::GetBigBetaLeftColumnToFill() {
+	return m_valueArena.data() + 2 * m_noOfBetaNodes + m_noOfBetaNodes * m_noOfEnergyNodes;
+}
+
+G4ChRTableValue* G4ChRPhysTableData::GetBigBetaRightColumnToFill() {
+	return m_valueArena.data() + 2 * m_noOfBetaNodes + (m_noOfBetaNodes + 1) * m_noOfEnergyNodes;
+}
+
+void G4ChRPhysTableData::UpdateBetaGridLookup() {
+	m_betaOrigin = 0.;
+	m_invDeltaBeta = 0.;
+	if (m_noOfBetaNodes < 2 || !(GetBackBeta() > GetFrontBeta()))
+		return;
+	const G4double deltaBeta = (GetBackBeta() - GetFrontBeta()) / static_cast<G4double>(m_noOfBetaNodes - 1);
+	for (size_t i = 1; i < m_noOfBetaNodes - 1; i++)
+		if (std::abs(m_axisArena[i] - (GetFrontBeta() + static_cast<G4double>(i) * deltaBeta)) > 1e-6 * deltaBeta)
+			return;
+	m_betaOrigin = GetFrontBeta();
+	m_invDeltaBeta = 1. / deltaBeta;
+}
+
+void G4ChRPhysTableData::BuildAliasTables() {
+	m_aliasProbabilities.clear();
+	m_aliasIndices.clear();
+	if (m_noOfEnergyNodes < 2)
+		return;
+	const size_t noOfIntervals = m_noOfEnergyNodes - 1;
+	m_aliasProbabilities.resize(m_noOfBetaNodes * noOfIntervals);
+	m_aliasIndices.resize(m_noOfBetaNodes * noOfIntervals);
+	std::vector<size_t> smallIntervals, largeIntervals;
+	smallIntervals.reserve(noOfIntervals);
+	largeIntervals.reserve(noOfIntervals);
+	for (size_t j = 0; j < m_noOfBetaNodes; j++) {
+		const G4ChRTableValue* cdfRow = GetCDFRow(j);
+		G4double* probabilities = m_aliasProbabilities.data() + j * noOfIntervals;
+		std::uint32_t* aliases = m_aliasIndices.data() + j * noOfIntervals;
+		smallIntervals.clear();
+		largeIntervals.clear();
+		// Vose's method - probabilities are scaled, so the average is 1
+		const G4double norm = static_cast<G4double>(cdfRow[noOfIntervals]) - cdfRow[0];
+		for (size_t k = 0; k < noOfIntervals; k++) {
+			probabilities[k] = norm > 0. ? (static_cast<G4double>(cdfRow[k + 1]) - cdfRow[k]) * noOfIntervals / norm : 1.;
+			aliases[k] = static_cast<std::uint32_t>(k);
+			(probabilities[k] < 1. ? smallIntervals : largeIntervals).push_back(k);
+		}
+		while (!smallIntervals.empty() && !largeIntervals.empty()) {
+			const size_t small = smallIntervals.back();
+			const size_t large = largeIntervals.back();
+			smallIntervals.pop_back();
+			aliases[small] = static_cast<std::uint32_t>(large);
+			probabilities[large] -= 1. - probabilities[small];
+			if (probabilities[large] < 1.) {
+				largeIntervals.pop_back();
+				smallIntervals.push_back(large);
+			}
+		}
+		// what's left is 1. up to round-off
+		for (size_t k : smallIntervals)
+			probabilities[k] = 1.;
+		for (size_t k : largeIntervals)
+			probabilities[k] = 1.;
+	}
+}
+
+void G4ChRPhysTableData::SetUniformRIndexGrid(const G4double minEnergy, const G4double maxEnergy, std::vector<G4double>&& RIndexValues) {
+	m_RIndexGrid = std::move(RIndexValues);
+	m_RIndexGridOrigin = minEnergy;
+	m_invDeltaRIndexEnergy = static_cast<G4double>(m_RIndexGrid.size() - 1) / (maxEnergy - minEnergy);
+}
+
+void G4ChRPhysTableData::SetRIndexGridError(const G4double maxError) {
+	m_RIndexGridError = maxError;
+}
+
+G4double* G4ChRPhysTableData::GetAxisArenaToFill() {
+	return m_axisArena.data();
+}
+
+G4ChRTableValue* G4ChRPhysTableData::GetValueArenaToFill() {
+	return m_valueArena.data();
+}
+
+//=======Get inlines=======
+
+size_t G4ChRPhysTableData::GetNoOfBetaNodes() const {
+	return m_noOfBetaNodes;
+}
+
+size_t G4ChRPhysTableData::GetNoOfEnergyNodes() const {
+	return m_noOfEnergyNodes;
+}
+
+G4bool G4ChRPhysTableData::HasCDFTables() const {
+	return m_noOfEnergyNodes != 0;
+}
+
+size_t G4ChRPhysTableData::GetArenaSizeInBytes() const {
+	return m_axisArena.capacity() * sizeof(G4double) + m_valueArena.capacity() * sizeof(G4ChRTableValue) + sizeof(G4ChRPhysTableData);
+}
+
+size_t G4ChRPhysTableData::GetAxisArenaSize() const {
+	return m_axisArena.size();
+}
+
+size_t G4ChRPhysTableData::GetValueArenaSize() const {
+	return m_valueArena.size();
+}
+
+const G4double* G4ChRPhysTableData::GetAxisArena() const {
+	return m_axisArena.data();
+}
+
+const G4ChRTableValue* G4ChRPhysTableData::GetValueArena() const {
+	return m_valueArena.data();
+}
+
+G4double G4ChRPhysTableData::GetBetaValue(const size_t betaID) const {
+	return m_axisArena[betaID];
+}
+
+G4double G4ChRPhysTableData::GetLeftIntegral(const size_t betaID) const {
+	return m_valueArena[betaID];
+}
+
+G4double G4ChRPhysTableData::GetRightIntegral(const size_t betaID) const {
+	return m_valueArena[m_noOfBetaNodes + betaID];
+}
+
+G4double G4ChRPhysTableData::GetFrontBeta() const {
+	return m_axisArena.front();
+}
+
+G4double G4ChRPhysTableData::GetBackBeta() const {
+	return m_axisArena[m_noOfBetaNodes - 1];
+}
+
+const G4double* G4ChRPhysTableData::GetBetaColumn() const {
+	return m_axisArena.data();
+}
+
+const G4ChRTableValue* G4ChRPhysTableData::GetLeftIntegralColumn() const {
+	return m_valueArena.data();
+}
+
+const G4ChRTableValue* G4ChRPhysTableData::GetRightIntegralColumn() const {
+	return m_valueArena.data() + m_noOfBetaNodes;
+}
+
+const G4double* G4ChRPhysTableData::GetEnergyColumn() const {
+	return m_axisArena.data() + m_noOfBetaNodes;
+}
+
+const G4ChRTableValue* G4ChRPhysTableData::GetCDFRow(const size_t betaID) const {
+	return m_valueArena.data() + 2 * m_noOfBetaNodes + betaID * m_noOfEnergyNodes;
+}
+
+const G4ChRTableValue* G4ChRPhysTableData::GetBigBetaLeftColumn() const {
+	return m_valueArena.data() + 2 * m_noOfBetaNodes + m_noOfBetaNodes * m_noOfEnergyNodes;
+}
+
+const G4ChRTableValue* G4ChRPhysTableData::GetBigBetaRightColumn() const {
+	return m_valueArena.data() + 2 * m_noOfBetaNodes + (m_noOfBetaNodes + 1) * m_noOfEnergyNodes;
+}
+
+G4bool G4ChRPhysTableData::HasUniformBetaGrid() const {
+	return m_invDeltaBeta != 0.;
+}
+
+G4bool G4ChRPhysTableData::HasAliasTables() const {
+	return !m_aliasIndices.empty();
+}
+
+G4bool G4ChRPhysTableData::HasUniformRIndexGrid() const {
+	return !m_RIndexGrid.empty();
+}
+
+size_t G4ChRPhysTableData::GetNoOfRIndexGridNodes() const {
+	return m_RIndexGrid.size();
+}
+
+G4double G4ChRPhysTableData::GetRIndexGridError() const {
+	return m_RIndexGridError;
+}
+
+//=======Additional inlines=======
+
+size_t G4ChRPhysTableData::FindUpperBetaNode(const G4double betaValue) const {
+	if (m_invDeltaBeta != 0.) {
+		// a node found this way might differ by one from the binary search for betaValue exactly on a node (round-off),
+		// but the interpolation between the two neighboring nodes gives the same value then
+		const G4double position = std::ceil((betaValue - m_betaOrigin) * m_invDeltaBeta);
+		return static_cast<size_t>(std::clamp(position, 1., static_cast<G4double>(m_noOfBetaNodes - 1)));
+	}
+	const G4double* betaColumn = GetBetaColumn();
+	size_t betaID = static_cast<size_t>(std::lower_bound(betaColumn + 1, betaColumn + m_noOfBetaNodes, betaValue) - betaColumn);
+	return std::min(betaID, m_noOfBetaNodes - 1);
+}
+
+G4double G4ChRPhysTableData::SampleEnergyFromCDF(const G4ChRTableValue* cdfRow, const G4double rand) const {
+	const G4double* energyColumn = GetEnergyColumn();
+	size_t lowLoc = static_cast<size_t>(std::lower_bound(cdfRow + 1, cdfRow + m_noOfEnergyNodes, rand) - cdfRow);
+	if (lowLoc == m_noOfEnergyNodes) // rand == 1. and a flat CDF tail
+		lowLoc--;
+	if (cdfRow[lowLoc] == cdfRow[lowLoc - 1])
+		return energyColumn[lowLoc];
+	const G4double lowerCDF = cdfRow[lowLoc - 1];
+	return energyColumn[lowLoc - 1] + (rand - lowerCDF) * (energyColumn[lowLoc] - energyColumn[lowLoc - 1]) / (cdfRow[lowLoc] - lowerCDF);
+}
+
+G4double G4ChRPhysTableData::SampleEnergyForBigBeta(const G4double beta, const G4double rand) const {
+	// all intervals emit photons above betaMax
+	return SampleEnergyAboveThreshold(beta, GetEnergyColumn()[0], rand);
+}
+
+G4double G4ChRPhysTableData::SampleEnergyAboveThreshold(const G4double beta, const G4double thresholdEnergy, const G4double rand) const {
+	const G4double* energyColumn = GetEnergyColumn();
+	const G4ChRTableValue* leftColumn = GetBigBetaLeftColumn();
+	const G4ChRTableValue* rightColumn = GetBigBetaRightColumn();
+	const G4double invBeta2 = 1. / (beta * beta);
+	// the interval that holds the threshold
+	const size_t thresholdLoc = static_cast<size_t>(std::upper_bound(energyColumn + 1, energyColumn + m_noOfEnergyNodes - 1, thresholdEnergy) - energyColumn);
+	const G4double thresholdFraction = (thresholdEnergy - energyColumn[thresholdLoc - 1]) / (energyColumn[thresholdLoc] - energyColumn[thresholdLoc - 1]);
+	const G4double thresholdCDF = leftColumn[thresholdLoc - 1] + thresholdFraction * (static_cast<G4double>(leftColumn[thresholdLoc]) - leftColumn[thresholdLoc - 1]) -
+		(rightColumn[thresholdLoc - 1] + thresholdFraction * (static_cast<G4double>(rightColumn[thresholdLoc]) - rightColumn[thresholdLoc - 1])) * invBeta2;
+	// above the threshold, the unnormalized CDF is non-decreasing
+	const G4double target = thresholdCDF + rand * (leftColumn[m_noOfEnergyNodes - 1] - rightColumn[m_noOfEnergyNodes - 1] * invBeta2 - thresholdCDF);
+	size_t lowLoc = thresholdLoc;
+	size_t highLoc = m_noOfEnergyNodes - 1;
+	while (lowLoc < highLoc) { // the first node with CDF >= target
+		const size_t midLoc = (lowLoc + highLoc) / 2;
+		if (leftColumn[midLoc] - rightColumn[midLoc] * invBeta2 < target)
+			lowLoc = midLoc + 1;
+		else
+			highLoc = midLoc;
+	}
+	const G4double lowerEnergy = lowLoc == thresholdLoc ? thresholdEnergy : energyColumn[lowLoc - 1];
+	const G4double lowerCDF = lowLoc == thresholdLoc ? thresholdCDF : leftColumn[lowLoc - 1] - rightColumn[lowLoc - 1] * invBeta2;
+	const G4double upperCDF = leftColumn[lowLoc] - rightColumn[lowLoc] * invBeta2;
+	if (upperCDF == lowerCDF)
+		return energyColumn[lowLoc];
+	return lowerEnergy + (target - lowerCDF) * (energyColumn[lowLoc] - lowerEnergy) / (upperCDF - lowerCDF);
+}
+
+G4double G4ChRPhysTableData::SampleEnergyFromAliasTable(const size_t betaID, const G4double rand1, const G4double rand2) const {
+	const size_t noOfIntervals = m_noOfEnergyNodes - 1;
+	const G4double scaledRand = rand1 * static_cast<G4double>(noOfIntervals);
+	size_t interval = std::min(static_cast<size_t>(scaledRand), noOfIntervals - 1);
+	if (scaledRand - static_cast<G4double>(interval) >= m_aliasProbabilities[betaID * noOfIntervals + interval])
+		interval = m_aliasIndices[betaID * noOfIntervals + interval];
+	const G4double* energyColumn = GetEnergyColumn();
+	return energyColumn[interval] + rand2 * (energyColumn[interval + 1] - energyColumn[interval]);
+}
+
+G4double G4ChRPhysTableData::GetRIndexValue(const G4double energy) const {
+	const size_t lastNode = m_RIndexGrid.size() - 1;
+	const G4double position = std::clamp((energy - m_RIndexGridOrigin) * m_invDeltaRIndexEnergy, 0., static_cast<G4double>(lastNode));
+	const size_t lowLoc = std::min(static_cast<size_t>(position), lastNode - 1);
+	return m_RIndexGrid[lowLoc] + (position - static_cast<G4double>(lowLoc)) * (m_RIndexGrid[lowLoc + 1] - m_RIndexGrid[lowLoc]);
+}
+
 #endif // !G4ChRPhysicsTableData_hh
\ No newline at end of file
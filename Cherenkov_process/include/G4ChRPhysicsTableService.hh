@@ -0,0 +1,279 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+/*
+ABOUT THE HEADER
+----------------
+
+G4ChRPhysicsTableService is a static class that owns the Cherenkov physics
+tables of all materials. Both process families, i.e., G4BaseChR_Model (and
+the G4CherenkovProcess models) and G4StandardCherenkovProcess, query the
+same tables, so the tables are built (and kept in memory) only once, even
+when both are used or when switching between G4OpticalPhysics_option1 and
+G4OpticalPhysics_option2.
+
+The number of photons is generated according to equation:
+dN/dl = 2 * Pi * alpha * z^2 / (h * c) * (leftIntegral - rightIntegral),
+where:
+leftIntegral = \int dE
+rightIntegral = \int dE / (beta^2 * RIndex^2)
+with limits: Emin -> Emax
+
+The physics tables are prepared to analyze any kind of RIndex dependency
+and are saved as a 'G4ChRPhysicsTableVector' of 'G4ChRPhysTableData', where
+'G4ChRPhysTableData' is a helper struct that keeps all values of a material
+in a single contiguous arena (see G4ChRPhysicsTableData.hh). Materials with
+the same RINDEX share a single table (see G4ChRPhysicsTableVector.hh):
+1. beta values - specific beta values that are used when a charged particle
+                 cannot emit Cherenkov photons on the whole RIndex spectrum
+2. left integral values (dE)
+3. right integral values (dE / RIndex^2)
+4. CDF rows - to keep normalized CDF values used to generate spectral
+			  distribution of ChR for low beta values. They share a single
+			  energy axis and are built for all materials, unless
+			  m_useRejectionSampling is set (then, only for exotic RIndex)
+
+And two columns of values for building CDFs for particles with beta values higher
+than betaMax:
+5. big-beta columns - cumulative left and right integrals for betaMax. They are
+					  used for beta values greater than the betaMax value (the
+					  value that can generate ChR photons on the whole RIndex
+					  spectrum). For non-exotic refractive indices (increasing
+					  with energy), they are used for all beta values - photons
+					  are emitted only above the threshold energy, so the CDF is
+					  inverted above it (GetThresholdEnergy) with a single draw
+
+Note that the ChR currently doesn't produce ChR photons in X-ray region (gammas).
+Also, the whole idea with the spectral distribution of exotic materials  is based
+on the theory and it still must be confirmed by an experiment.
+
+Exotic RIndex tables of a material are built if any logical volume with the
+material has the exotic flag set (G4CherenkovMatData). Logical volumes that
+are not registered in G4ExtraOpticalParameters (G4StandardCherenkovProcess
+doesn't use it) use the initial flag, i.e., a non-monotonic RIndex.
+
+Static member variables:
+1. m_noOfBetaSteps - for filling the beta-values vector from betaMin to
+                     betaMax with "m_noOfBetaStep + 1" nodes
+2. m_betaGridTolerance - if > 0, m_noOfBetaSteps is not used, but beta nodes
+                     are added (by bisection) only where the photon yield
+					 (relative to the yield at betaMax) or CDF values deviate
+					 from the linear interpolation by more than the tolerance
+3. m_useRejectionSampling - set to true to use the old photon-energy sampling
+                     of non-exotic materials (uniform energies, rejected until
+					 beta * RIndex > 1) and build CDF tables only for exotic
+					 RIndex; kept for validation
+4. m_useExactIntegration - if set, integrals are not calculated with the
+                     trapezoidal rule, but exactly for the RIndex interpolation
+					 Geant4 uses (G4PhysicsVector::Value), i.e., analytically for
+					 linear RIndex and with the Gauss-Legendre quadrature between
+					 (bisected) threshold crossings for spline RIndex (if second
+					 derivatives are filled). The threshold energy is exact as
+					 well, so coarse RIndex tabulations give accurate tables
+5. m_noOfRIndexGridNodes - if >= 2, RIndex of each table is resampled onto a
+                     uniform energy grid with that many nodes, so models find
+					 RIndex(E) of sampled photons by direct indexing instead of
+					 the bin search of G4PhysicsVector::Value. The max. error
+					 of the resampled RIndex is printed with the tables (verbose
+					 level 1). The grid is not stored in files and it's not a
+					 part of keys, so the tables must be rebuilt (the UI command
+					 does it) after changing the value
+
+Each material table is identified by a key (fingerprint) of its RINDEX,
+exotic flag and beta-grid parameters (G4ChRPhysicsTableCache). When
+BuildPhysicsTables is called (each run initialization), keys are compared
+with the keys of the current tables, so only tables of materials that were
+added or changed (e.g., a new RINDEX or a flipped exotic flag) are built.
+After changing any of the static member variables 1-4, all keys are changed,
+so all tables are rebuilt.
+
+The tables are published in a read-copy-update manner. Only the master
+thread builds or changes them - it prepares a new G4ChRPhysicsTableVector
+and atomically replaces the published (immutable) one. Workers never
+mutate or rebuild the tables; each model/process instance keeps a
+G4ChRPhysicsTableSnapshot, i.e., a shared read-only pointer that is updated
+(at the beginning of a step) only if a new generation has been published.
+The old tables stay alive until the last snapshot that uses them is updated.
+*/
+
+#pragma once
+#ifndef G4ChRPhysicsTableService_hh
+#define G4ChRPhysicsTableService_hh
+
+//G4 headers
+#include "globals.hh"
+#include "G4ChRPhysicsTableVector.hh"
+#include "G4PhysicsFreeVector.hh"
+//std:: headers
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+class G4Material;
+
+// see G4ChRPhysicsTableService::EstimateInterpolationErrors
+struct G4ChRInterpolationErrors {
+	G4double m_yieldError = 0.;
+	G4double m_CDFError = 0.;
+};
+
+class G4ChRPhysicsTableService final {
+public:
+	G4ChRPhysicsTableService() = delete;
+
+	// the following methods (up to RemoveExoticRIndexPhysicsTable) change the tables, so they do nothing on worker threads
+	// builds tables of added or changed materials (see G4ChRPhysicsTableVector); returns true if any table was changed
+	static G4bool BuildPhysicsTables(const unsigned char verboseLevel = 0);
+	static inline void ClearPhysicsTables();
+	// binary files (see G4ChRPhysicsTableCache.hh) to skip the integration when restarting with the same materials
+	static G4bool StorePhysicsTables(const G4String& directory);
+	// the file is read only if tables are not built yet, otherwise it's the same as BuildPhysicsTables
+	static G4bool RetrievePhysicsTables(const G4String& directory, const unsigned char verboseLevel = 0);
+
+	// the following method tries, but adds physics table with exotic RI or not. Nevertheless, they primarily use exotic if possible
+	static G4bool AddExoticRIndexPhysicsTable(const size_t materialID, G4bool forceExoticFlag = false);
+	static void RemoveExoticRIndexPhysicsTable(const size_t materialID);
+
+	[[nodiscard]] static G4double CalculateAverageNumberOfPhotons(const G4double aCharge, const G4double betaValue, const G4ChRPhysTableData& physData);
+	// the lowest energy that emits ChR photons for the given beta, if RIndex increases with energy
+	[[nodiscard]] static G4double GetThresholdEnergy(const G4PhysicsFreeVector* RIndex, const G4double beta);
+
+	static void PrintChRPhysDataVec(const unsigned char printLevel = 0, const G4Material* aMaterial = nullptr);
+	// aMaterial == nullptr -> prints physics tables for all registered materials
+	// aMaterial == someMaterial -> prints physics tables for a someMaterial
+	// printLevel == 0 -> print only basic available information about registered physics tables
+	// printLevel == 1 -> print standard + CDF values
+	// printLevel >= 2 -> print all available information about registered physics tables
+	// compares the stored tables with the double-precision integration at their beta nodes and prints the max. errors
+	// of photon yields and spectra (CDFs), and the table memory, e.g., to validate float tables (G4ChR_USE_FLOAT_TABLES)
+	static void ValidatePhysicsTables();
+	// max. errors of the table of a material in the middle of all beta intervals, i.e., where they are the largest, compared
+	// with the direct integration: the yield error (linear interpolation, relative to the yield at betaMax) and the CDF error
+	// of the row models sample from (the upper beta node). Both are 0 for tables without beta intervals
+	[[nodiscard]] static G4ChRInterpolationErrors EstimateInterpolationErrors(const size_t materialID);
+
+	//=======Set inlines=======
+	inline static unsigned int SetNoOfBetaSteps(const unsigned int);
+	inline static G4double SetBetaGridTolerance(const G4double);
+	inline static G4bool SetUseRejectionSampling(const G4bool);
+	inline static G4bool SetUseExactIntegration(const G4bool);
+	inline static unsigned int SetNoOfRIndexGridNodes(const unsigned int);
+
+	//=======Get inlines=======
+	[[nodiscard]] inline static unsigned int GetNoOfBetaSteps();
+	[[nodiscard]] inline static G4double GetBetaGridTolerance();
+	[[nodiscard]] inline static G4bool GetUseRejectionSampling();
+	[[nodiscard]] inline static G4bool GetUseExactIntegration();
+	[[nodiscard]] inline static unsigned int GetNoOfRIndexGridNodes();
+	// the latest published tables; use G4ChRPhysicsTableSnapshot while tracking
+	[[nodiscard]] inline static std::shared_ptr<const G4ChRPhysicsTableVector> GetChRPhysDataVec();
+	[[nodiscard]] inline static std::uint64_t GetTablesGeneration();
+private:
+	// accessed only with std::atomic_load_explicit/std::atomic_store_explicit (std::atomic<std::shared_ptr> is C++20)
+	static std::shared_ptr<const G4ChRPhysicsTableVector> m_ChRPhysDataVec;
+	static std::atomic<std::uint64_t> m_tablesGeneration;
+	static unsigned int m_noOfBetaSteps;
+	static G4double m_betaGridTolerance;
+	static G4bool m_useRejectionSampling;
+	static G4bool m_useExactIntegration;
+	static unsigned int m_noOfRIndexGridNodes;
+
+	// looks for logical volumes of the material that ask for exotic RIndex tables
+	static G4bool GetExoticRIndexFlag(const size_t materialID);
+	// CDF tables are needed for all materials, unless m_useRejectionSampling is set
+	static G4bool GetCDFTablesFlag(const size_t materialID);
+	// builds the tables of a single material without touching m_ChRPhysDataVec (safe to be called concurrently)
+	static G4bool BuildPhysicsTableData(const size_t materialID, G4bool forceExoticFlag, G4ChRPhysTableData& thePhysVecData);
+	// resamples RIndex onto m_noOfRIndexGridNodes uniform energy nodes (does nothing if m_noOfRIndexGridNodes < 2)
+	static void BuildUniformRIndexGrid(const G4PhysicsVector* RIndex, G4ChRPhysTableData& thePhysVecData);
+	// replaces the published tables (master thread only)
+	static void PublishChRPhysDataVec(G4ChRPhysicsTableVector&& newPhysDataVec);
+};
+
+// a read-only view of the published tables kept by a model/process instance (i.e., by a single thread)
+class G4ChRPhysicsTableSnapshot final {
+public:
+	// takes the latest published tables if a new generation has been published - references from Get() are not valid after this call
+	// returns true if new tables have been taken
+	inline G4bool Update();
+	[[nodiscard]] inline const G4ChRPhysicsTableVector& Get() const;
+private:
+	std::shared_ptr<const G4ChRPhysicsTableVector> m_snapshot = G4ChRPhysicsTableService::GetChRPhysDataVec();
+	std::uint64_t m_generation = 0;
+};
+
+//=======Set inlines=======
+unsigned int G4ChRPhysicsTableService::SetNoOfBetaSteps(const unsigned int value) {
+	unsigned int temp = m_noOfBetaSteps;
+	m_noOfBetaSteps = value;
+	return temp;
+}
+G4double G4ChRPhysicsTableService::SetBetaGridTolerance(const G4double value) {
+	G4double temp = m_betaGridTolerance;
+	m_betaGridTolerance = value;
+	return temp;
+}
+G4bool G4ChRPhysicsTableService::SetUseRejectionSampling(const G4bool value) {
+	G4bool temp = m_useRejectionSampling;
+	m_useRejectionSampling = value;
+	return temp;
+}
+G4bool G4ChRPhysicsTableService::SetUseExactIntegration(const G4bool value) {
+	G4bool temp = m_useExactIntegration;
+	m_useExactIntegration = value;
+	return temp;
+}
+unsigned int G4ChRPhysicsTableService::SetNoOfRIndexGridNodes(const unsigned int value) {
+	unsigned int temp = m_noOfRIndexGridNodes;
+	m_noOfRIndexGridNodes = value;
+	return temp;
+}
+
+//=======Get inlines=======
+unsigned int G4ChRPhysicsTableService::GetNoOfBetaSteps() {
+	return m_noOfBetaSteps;
+}
+G4double G4ChRPhysicsTableService::GetBetaGridTolerance() {
+	return m_betaGridTolerance;
+}
+G4bool G4ChRPhysicsTableService::GetUseRejectionSampling() {
+	return m_useRejectionSampling;
+}
+G4bool G4ChRPhysicsTableService::GetUseExactIntegration() {
+	return m_useExactIntegration;
+}
+unsigned int G4ChRPhysicsTableService::GetNoOfRIndexGridNodes() {
+	return m_noOfRIndexGridNodes;
+}
+std::shared_ptr<const G4ChRPhysicsTableVector> G4ChRPhysicsTableService::GetChRPhysDataVec() {
+	return std::atomic_load_explicit(&m_ChRPhysDataVec, std::memory_order_acquire);
+}
+std::uint64_t G4ChRPhysicsTableService::GetTablesGeneration() {
+	return m_tablesGeneration.load(std::memory_order_acquire);
+}
+
+//=======Additional inlines=======
+void G4ChRPhysicsTableService::ClearPhysicsTables() {
+	PublishChRPhysDataVec(G4ChRPhysicsTableVector{});
+}
+
+G4bool G4ChRPhysicsTableSnapshot::Update() {
+	// the generation is increased after the tables are published, so the snapshot is never older than its generation
+	const std::uint64_t currentGeneration = G4ChRPhysicsTableService::GetTablesGeneration();
+	if (currentGeneration == m_generation)
+		return false;
+	m_generation = currentGeneration;
+	m_snapshot = G4ChRPhysicsTableService::GetChRPhysDataVec();
+	return true;
+}
+
+const G4ChRPhysicsTableVector& G4ChRPhysicsTableSnapshot::Get() const {
+	return *m_snapshot;
+}
+
+#endif // !G4ChRPhysicsTableService_hh
\ No newline at end of file
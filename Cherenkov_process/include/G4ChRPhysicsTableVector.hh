@@ -0,0 +1,111 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+/*
+ABOUT THE HEADER
+----------------
+
+G4ChRPhysicsTableVector maps material indices to Cherenkov physics tables
+(G4ChRPhysTableData). It replaces the previous std::vector<G4ChRPhysTableData>
+and it's used in the same way, i.e., physicsTableVector[materialID].
+
+Materials made with G4NistManager::BuildMaterialWithNewDensity (or other
+density variants of the same material) usually have the same RINDEX, so
+their tables would be the same. When building (BuildTables), each material
+gets a key - a hash of the RINDEX energy and value vectors, the exotic
+RIndex flag and beta-grid parameters (see G4ChRPhysicsTableCache). A table
+is built only once per key and all materials with that key share the same
+immutable instance. Large detector descriptions with hundreds of material
+variants then keep only a few tables.
+
+Tables are never modified after they are built. If a table of a single
+material must be changed (e.g., after changing its exotic RIndex flag),
+a new table is given to that material with SetTable, so other materials
+that shared the old table are not affected.
+
+The key of each material table is kept as well (the fingerprint of the
+table). When materials are added or their RINDEX/flags are changed between
+runs, the tables of the current vector can be passed as availableTables
+(GetSharedTables), so only tables with new keys are built.
+*/
+
+#pragma once
+#ifndef G4ChRPhysicsTableVector_hh
+#define G4ChRPhysicsTableVector_hh
+
+//G4 headers
+#include "globals.hh"
+#include "G4ChRPhysicsTableData.hh"
+//std:: headers
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+
+class G4ChRPhysicsTableVector final {
+public:
+	// materialID, forceExoticFlag, table to fill -> same as BuildPhysicsTableData methods
+	using G4ChRBuildTableFunction = G4bool(*)(const size_t, G4bool, G4ChRPhysTableData&);
+	using G4ChRSharedTableMap = std::unordered_map<std::uint64_t, std::shared_ptr<const G4ChRPhysTableData>>;
+
+	G4ChRPhysicsTableVector() = default;
+	~G4ChRPhysicsTableVector() = default;
+
+	// materialKeys[materialID] is the key of the material table. Tables of keys found in availableTables are used as they
+	// are, others are built with aBuildFunction (on the task pool), once per key. Returns the number of built tables
+	size_t BuildTables(const std::vector<std::uint64_t>& materialKeys, G4ChRBuildTableFunction aBuildFunction,
+		const G4ChRSharedTableMap& availableTables = G4ChRSharedTableMap{});
+	// gives a new table (with its key) only to materialID (materialID >= size() adds the material, and materials
+	// between size() and materialID share an empty table, i.e., they have no Cherenkov tables)
+	void SetTable(const size_t materialID, const std::uint64_t materialKey, G4ChRPhysTableData&& aTable);
+	[[nodiscard]] size_t GetNoOfUniqueTables() const;
+	// key -> table map of all current tables, to be reused by BuildTables
+	[[nodiscard]] G4ChRSharedTableMap GetSharedTables() const;
+
+	//=======Get inlines=======
+	[[nodiscard]] inline const G4ChRPhysTableData& operator[](const size_t materialID) const;
+	[[nodiscard]] inline const G4ChRPhysTableData& at(const size_t materialID) const;
+	[[nodiscard]] inline size_t size() const;
+	[[nodiscard]] inline G4bool empty() const;
+	[[nodiscard]] inline const std::vector<std::uint64_t>& GetMaterialKeys() const;
+
+	//=======Additional inlines=======
+	inline void clear();
+private:
+	std::vector<std::shared_ptr<const G4ChRPhysTableData>> m_materialTables;
+	std::vector<std::uint64_t> m_materialKeys;
+};
+
+//=======Get inlines=======
+const G4ChRPhysTableData& G4ChRPhysicsTableVector::operator[](const size_t materialID) const {
+	return *m_materialTables[materialID];
+}
+
+const G4ChRPhysTableData& G4ChRPhysicsTableVector::at(const size_t materialID) const {
+	return *m_materialTables.at(materialID);
+}
+
+size_t G4ChRPhysicsTableVector::size() const {
+	return m_materialTables.size();
+}
+
+G4bool G4ChRPhysicsTableVector::empty() const {
+	return m_materialTables.empty();
+}
+
+const std::vector<std::uint64_t>& G4ChRPhysicsTableVector::GetMaterialKeys() const {
+	return m_materialKeys;
+}
+
+//=======Additional inlines=======
+void G4ChRPhysicsTableVector::clear() {
+	m_materialTables.clear();
+	m_materialKeys.clear();
+}
+
+#endif // !G4ChRPhysicsTableVector_hh
\ No newline at end of file
@@ -0,0 +1,186 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+/*
+ABOUT THE HEADER
+----------------
+
+G4ChRRandomBuffer draws uniform random numbers of a Cherenkov step in bulk,
+i.e., with HepRandomEngine::flatArray, instead of a G4UniformRand() call
+(a virtual call of the engine) for each energy, phi, step fraction and
+retry of each photon. G4ChRPhotonBatch::Generate prefetches all numbers it
+expects to need in a single engine call, and kernels read them from the
+buffer:
+1. Take  - a contiguous block of numbers (e.g., phi of all photons)
+2. Flat  - a single number (e.g., energy sampling with an unknown number of
+           retries); if the buffer is empty, a small block is drawn
+3. Gauss - a standard normal number; numbers are generated in pairs (the
+           polar method, as in CLHEP::RandGauss), so every second call is
+           free
+Numbers come from the same (thread-local) engine, so only the order of
+draws changes, and not the distributions.
+
+Clear must be called at the end of each step, i.e., numbers are never kept
+between steps. Otherwise, numbers drawn in one event could be used in the
+next one, and events could not be reproduced by reseeding them.
+Each G4ChRPhotonBatch (so each model or process on each thread) owns its
+buffer, so there's no need for G4ThreadLocal.
+
+Counter-based mode (EnableCounterBasedMode) - numbers are not taken from the
+engine, but from Philox4x32-10 (a counter-based generator; J.K. Salmon et
+al., Parallel random numbers: as easy as 1, 2, 3, SC11), so each number is a
+pure function of (seed, run ID, event ID, track ID, step number, stream
+ID, draw):
+1. BeginStep       - sets the key (the seed hashed with the run ID, and the
+                     step number) and the event and track IDs of the step
+2. SelectStream    - Flat and Gauss numbers are taken from a stream, i.e.,
+                     the number 'draw' of the stream, 'draw + 1' etc.
+                     G4ChRPhotonBatch uses the index of each photon as its
+                     stream ID, and m_stepStreamID for the number of photons
+                     (Poisson)
+3. FillStreams     - two numbers of each of 'count' streams, e.g., phi and
+                     the step fraction of all photons
+Numbers of a photon then don't depend on other photons, threads, or the
+engine state, so photons of a step can be generated in any order (or in
+parallel), and photons of a step are the same no matter which thread
+simulates the event. Other processes still use the engine, so bitwise
+reproducible MT runs also need the same engine seed of the master (i.e., of
+event seeds). Event IDs restart in each run, so the run ID is hashed into
+the key, i.e., runs of a job get independent photons, while a job with the
+same seed (and the same sequence of runs) reproduces them. The mode and the
+seed are shared by all threads, so they may be changed only between runs.
+*/
+
+#pragma once
+#ifndef G4ChRRandomBuffer_hh
+#define G4ChRRandomBuffer_hh
+
+//G4 headers
+#include "globals.hh"
+#include "Randomize.hh"
+//std:: headers
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+class G4Track;
+
+class G4ChRRandomBuffer {
+public:
+	// makes sure that at least 'count' numbers are buffered, drawing the missing ones in a single engine call
+	void Prefetch(const size_t count);
+	// 'count' consecutive numbers; the pointer is valid until the next call of any other method
+	[[nodiscard]] inline const G4double* Take(const size_t count);
+	[[nodiscard]] inline G4double Flat();
+	[[nodiscard]] inline G4double Gauss();
+	[[nodiscard]] inline G4double Gauss(const G4double mean, const G4double stdDev);
+	// as G4Poisson, with numbers of the buffer (of m_stepStreamID in counter-based mode)
+	[[nodiscard]] G4long Poisson(const G4double mean);
+	// drops all buffered numbers (and the spare Gaussian number)
+	inline void Clear();
+
+	//=======Counter-based mode=======
+	// for all threads
+	static void EnableCounterBasedMode(const G4long seed);
+	static void DisableCounterBasedMode();
+	[[nodiscard]] static G4bool IsCounterBasedModeEnabled();
+	[[nodiscard]] static G4long GetCounterBasedSeed();
+
+	// must be called before any number of a step is drawn; nothing is done if the mode is disabled
+	void BeginStep(const G4Track& aTrack);
+	// true if the current step uses counter-based numbers
+	[[nodiscard]] inline G4bool IsCounterBased() const;
+	// counter-based mode only
+	inline void SelectStream(const std::uint32_t streamID, const std::uint32_t firstDraw = 0);
+	// first[i] and second[i] are the numbers 2 * block and 2 * block + 1 of the stream i (counter-based mode only)
+	void FillStreams(G4double* first, G4double* second, const size_t count, const std::uint32_t block) const;
+
+	static constexpr std::uint32_t m_stepStreamID = 0xFFFFFFFF;
+
+private:
+	// two numbers of the stream (the draws 2 * block and 2 * block + 1)
+	void ComputeCounterBlock(const std::uint32_t streamID, const std::uint32_t block, G4double& first, G4double& second) const;
+	[[nodiscard]] G4double NextCounterFlat();
+
+	// the smallest number of values drawn by Flat on an empty buffer
+	static constexpr size_t m_minRefill = 64;
+
+	std::vector<G4double> m_values;
+	size_t m_position = 0;
+	size_t m_end = 0;
+	G4double m_spareGauss = 0.;
+	G4bool m_hasSpareGauss = false;
+	// counter-based mode
+	G4bool m_isCounterBased = false;
+	G4bool m_hasCachedDraw = false; // the second number of the last block
+	G4double m_cachedDraw = 0.;
+	std::uint64_t m_runKey = 0; // the seed hashed with m_runID
+	G4int m_runID = -1;
+	G4bool m_hasRunKey = false;
+	std::uint32_t m_key[2] = { 0, 0 };
+	std::uint32_t m_eventID = 0;
+	std::uint32_t m_trackID = 0;
+	std::uint32_t m_streamID = 0;
+	std::uint32_t m_draw = 0;
+};
+
+//=======Additional inlines=======
+const G4double* G4ChRRandomBuffer::Take(const size_t count) {
+	Prefetch(count);
+	const G4double* theValues = m_values.data() + m_position;
+	m_position += count;
+	return theValues;
+}
+
+G4double G4ChRRandomBuffer::Flat() {
+	if (m_isCounterBased)
+		return NextCounterFlat();
+	if (m_position == m_end)
+		Prefetch(m_minRefill);
+	return m_values[m_position++];
+}
+
+G4double G4ChRRandomBuffer::Gauss() {
+	if (m_hasSpareGauss) {
+		m_hasSpareGauss = false;
+		return m_spareGauss;
+	}
+	G4double u, v, s;
+	do {
+		u = 2. * Flat() - 1.;
+		v = 2. * Flat() - 1.;
+		s = u * u + v * v;
+	} while (s >= 1. || s == 0.);
+	const G4double factor = std::sqrt(-2. * std::log(s) / s);
+	m_spareGauss = v * factor;
+	m_hasSpareGauss = true;
+	return u * factor;
+}
+
+G4double G4ChRRandomBuffer::Gauss(const G4double mean, const G4double stdDev) {
+	return mean + stdDev * Gauss();
+}
+
+void G4ChRRandomBuffer::Clear() {
+	m_position = m_end = 0;
+	m_hasSpareGauss = false;
+	m_isCounterBased = false;
+}
+
+G4bool G4ChRRandomBuffer::IsCounterBased() const {
+	return m_isCounterBased;
+}
+
+void G4ChRRandomBuffer::SelectStream(const std::uint32_t streamID, const std::uint32_t firstDraw) {
+	m_streamID = streamID;
+	m_draw = firstDraw;
+	m_hasCachedDraw = false;
+	m_hasSpareGauss = false;
+}
+
+#endif // !G4ChRRandomBuffer_hh
\ No newline at end of file
@@ -0,0 +1,67 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+/*
+ABOUT THE HEADER
+----------------
+
+G4ChRResolvedOptics is a compact (64 bytes on x64, i.e., a single cache
+line) descriptor of everything a Cherenkov model needs for a logical
+volume. Previously, each step looked up the G4CherenkovMatData of the
+volume (an unordered_map), the RINDEX (and REALRINDEX) property of the
+material, G4OpticalParameters flags and the physics table of the material.
+Now, G4CherenkovProcess resolves all of that once per logical volume (in
+BuildPhysicsTable) and passes a single descriptor to the models.
+
+Descriptors point to tables of the G4ChRPhysicsTableSnapshot kept by
+G4CherenkovProcess, so they are resolved again when new tables are
+published or G4CherenkovMatData is changed (see
+G4ExtraOpticalParameters::GetChRMatDataGeneration). G4OpticalParameters
+flags are read when the descriptors are resolved, i.e., in the same way
+G4Cerenkov reads them in PreparePhysicsTable.
+
+Note that the yield constant (2 * Pi * alpha / (h * c)) is a compile-time
+constant of G4ChRPhysicsTableService::CalculateAverageNumberOfPhotons
+and the charge depends on the particle, so nothing is kept for it.
+*/
+
+#pragma once
+#ifndef G4ChRResolvedOptics_hh
+#define G4ChRResolvedOptics_hh
+
+//G4 headers
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4PhysicsFreeVector.hh"
+#include "G4ChRPhysicsTableData.hh"
+
+class G4BaseChR_Model;
+
+struct G4ChRResolvedOptics {
+	const G4ChRPhysTableData* p_physData = nullptr;
+	const G4PhysicsFreeVector* p_RIndex = nullptr; // RINDEX, or REALRINDEX if RINDEX is not defined
+	G4BaseChR_Model* p_executeModel = nullptr;
+	// thin-target geometry (see G4CherenkovMatData and G4ThinTargetChR_Model)
+	const G4ThreeVector* p_middlePoint = nullptr;
+	G4double m_halfThickness = -1000.;
+	// RIndex energy range
+	G4double m_minEnergy = 0.;
+	G4double m_maxEnergy = 0.;
+	G4bool m_exoticRIndex = false;
+	G4bool m_exoticInitialFlag = false;
+	// exotic RIndex or CDF sampling of non-exotic RIndex (see G4ChRPhysicsTableService::m_useRejectionSampling)
+	G4bool m_useCDFSampling = false;
+	G4bool m_stackPhotons = true;
+	G4bool m_trackSecondariesFirst = false;
+	unsigned char m_minAxis = 255; // 0 - x min; 1 - y min; 2 - z min; >2 fail
+	// weighted photon thinning (see G4ExtraOpticalParameters.hh); 1 - no thinning
+	unsigned short m_thinningFactor = 1;
+	// 1 wasted byte on x64
+};
+
+#endif // !G4ChRResolvedOptics_hh
\ No newline at end of file
@@ -18,6 +18,12 @@ ID in the vector (with a help of the G4ExtraOpticalParameters class).
 To better understand how it works, consider running methods DumpInfo
 and ProcessDescription while in the G4State_Idle.
 
+The selected model, RINDEX, physics table and G4CherenkovMatData of each
+logical volume are resolved into a G4ChRResolvedOptics descriptor (in
+BuildPhysicsTable), so a step needs only a single lookup (none if the
+track stays in the same logical volume). Descriptors are resolved again
+when new physics tables are published or G4CherenkovMatData is changed.
+
 The class is loaded through the G4OpticalPhysics_option2 class
 */
 
@@ -30,9 +36,12 @@ The class is loaded through the G4OpticalPhysics_option2 class
 //...
 #include "G4BaseChR_Model.hh"
 #include "G4ExtraOpticalParameters.hh"
+#include "G4ChRResolvedOptics.hh"
 //std:: headers
 #include <vector>
 #include <typeinfo>
+#include <cstdint>
+#include <unordered_map>
 
 class G4CherenkovProcess_Messenger;
 
@@ -66,43 +75,40 @@ public:
 	//=======Additional inlines=======
 	inline G4bool AddNewChRModel(G4BaseChR_Model* aModel);
 	inline const G4BaseChR_Model* GetChRModel(const size_t anID) const;
+	// e.g., to set angular biasing of a model (see G4ChRAngularBiasing.hh)
+	inline G4BaseChR_Model* GetChRModel(const size_t anID);
 	inline size_t GetNumberOfRegisteredModels() const;
 protected:
 	virtual G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*) override { return -1; }; //it was pure virtual
 	std::vector<G4BaseChR_Model*> m_registeredModels;
 private:
-	G4CherenkovMatData* p_selectedMatData = nullptr;
-	G4BaseChR_Model* p_selectedModel = nullptr;
+	// resolves descriptors of all logical volumes if tables or G4CherenkovMatData have been changed
+	inline void UpdateResolvedOptics();
+	void ResolveAllOptics();
+	G4ChRResolvedOptics& FindOrResolveOptics(const G4LogicalVolume*);
+
+	// tables the descriptors point to
+	G4ChRPhysicsTableSnapshot m_ChRPhysDataSnapshot;
+	std::unordered_map<const G4LogicalVolume*, G4ChRResolvedOptics> m_resolvedOptics;
+	std::uint64_t m_ChRMatDataGeneration = 0;
+	const G4LogicalVolume* p_selectedLogicVolume = nullptr;
+	G4ChRResolvedOptics* p_selectedOptics = nullptr;
 	G4CherenkovProcess_Messenger* p_ChRProcessMessenger = nullptr;
 };
 
 //=======Inlines=======
 G4double G4CherenkovProcess::PostStepGetPhysicalInteractionLength(const G4Track& aTrack, G4double previousStepSize, G4ForceCondition* aForceCondition) {
-	try {
-		// the following might be a problem if the rebuilding geometry and adding new LV in later phases
-		// might need to add 'if (p_selectedMatData) throw ...'
-		p_selectedMatData = &G4ExtraOpticalParameters::GetInstance()->FindOrCreateChRMatData(aTrack.GetVolume()->GetLogicalVolume());
-		p_selectedModel = m_registeredModels.at(p_selectedMatData->m_executeModel);
-		return p_selectedModel->PostStepModelIntLength(aTrack, previousStepSize, aForceCondition);
-	}
-	catch (std::out_of_range) {
-		std::ostringstream err;
-		err << "A Cherenkov model with ID: "
-			<< G4ExtraOpticalParameters::GetInstance()->FindOrCreateChRMatData(aTrack.GetVolume()->GetLogicalVolume()).m_executeModel
-			<< " not found while you are trying to execute it!\n";
-		G4Exception("G4CherenkovProcess::PostStepGetPhysicalInteractionLength", "FE_ChRProcess01", FatalException, err);
-		return DBL_MAX; //just to make sure no compiler would complain
-	}
-	catch (...) {
-		std::ostringstream err;
-		err << "An unexpected error has occurred while trying to obtain Cherenkov model interaction length!\nPlease, report this bug.\n";
-		G4Exception("G4CherenkovProcess::PostStepGetPhysicalInteractionLength", "FE_ChRProcess02", FatalException, err);
-		return DBL_MAX; //just to make sure no compiler would complain
+	UpdateResolvedOptics();
+	const G4LogicalVolume* aLogicVolume = aTrack.GetVolume()->GetLogicalVolume();
+	if (aLogicVolume != p_selectedLogicVolume) {
+		p_selectedOptics = &FindOrResolveOptics(aLogicVolume);
+		p_selectedLogicVolume = aLogicVolume;
 	}
+	return p_selectedOptics->p_executeModel->PostStepModelIntLength(aTrack, previousStepSize, aForceCondition, *p_selectedOptics);
 }
 
 G4VParticleChange* G4CherenkovProcess::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep) {
-	return p_selectedModel->PostStepModelDoIt(aTrack, aStep, *p_selectedMatData);
+	return p_selectedOptics->p_executeModel->PostStepModelDoIt(aTrack, aStep, *p_selectedOptics);
 }
 
 G4bool G4CherenkovProcess::IsApplicable(const G4ParticleDefinition& aParticle) {
@@ -122,11 +128,13 @@ void G4CherenkovProcess::StartTracking(G4Track* aTrack) {
 void G4CherenkovProcess::BuildPhysicsTable(const G4ParticleDefinition& aParticle) {
 	for (auto* aModel : m_registeredModels)
 		aModel->BuildModelPhysicsTable(aParticle);
+	UpdateResolvedOptics();
 }
 
 void G4CherenkovProcess::PreparePhysicsTable(const G4ParticleDefinition& aParticle) {
 	for (auto* aModel : m_registeredModels)
 		aModel->PrepareModelPhysicsTable(aParticle);
+	m_ChRMatDataGeneration = 0; // G4OpticalParameters might have been changed
 }
 
 G4bool G4CherenkovProcess::StorePhysicsTable(const G4ParticleDefinition* aParticle, const G4String& aString, G4bool aFlag) {
@@ -142,17 +150,20 @@ G4bool G4CherenkovProcess::RetrievePhysicsTable(const G4ParticleDefinition* aPar
 	for (auto* aModel : m_registeredModels)
 		if (!aModel->RetrieveModelPhysicsTable(aParticle, aString, aFlag))
 			returnValue = false;
+	UpdateResolvedOptics();
 	return returnValue;
 }
 
 void G4CherenkovProcess::BuildWorkerPhysicsTable(const G4ParticleDefinition& aParticle) {
 	for (auto* aModel : m_registeredModels)
 		aModel->BuildWorkerModelPhysicsTable(aParticle);
+	UpdateResolvedOptics();
 }
 
 void G4CherenkovProcess::PrepareWorkerPhysicsTable(const G4ParticleDefinition& aParticle) {
 	for (auto* aModel : m_registeredModels)
 		aModel->PrepareWorkerModelPhysicsTable(aParticle);
+	m_ChRMatDataGeneration = 0; // G4OpticalParameters might have been changed
 }
 
 //=======Additional inlines=======
@@ -187,8 +198,19 @@ const G4BaseChR_Model* G4CherenkovProcess::GetChRModel(const size_t anID) const
 	}
 }
 
+G4BaseChR_Model* G4CherenkovProcess::GetChRModel(const size_t anID) {
+	return const_cast<G4BaseChR_Model*>(static_cast<const G4CherenkovProcess&>(*this).GetChRModel(anID));
+}
+
 size_t G4CherenkovProcess::GetNumberOfRegisteredModels() const {
 	return m_registeredModels.size();
 }
 
+//=======Private inlines=======
+void G4CherenkovProcess::UpdateResolvedOptics() {
+	// the snapshot must always be updated, so it's the first operand
+	if (m_ChRPhysDataSnapshot.Update() || m_ChRMatDataGeneration != G4ExtraOpticalParameters::GetChRMatDataGeneration())
+		ResolveAllOptics();
+}
+
 #endif // !G4CherenkovProcess_hh
\ No newline at end of file
@@ -18,6 +18,7 @@ class G4UIDirectory;
 class G4UIcommand;
 class G4UIcmdWithABool;
 class G4UIcmdWithAnInteger;
+class G4UIcmdWithADouble;
 class G4UIcmdWithAString;
 
 class G4CherenkovProcess_Messenger : public G4UImessenger {
@@ -38,8 +39,19 @@ private:
 	//BaseChR_Model commands
 	G4UIcmdWithABool* p_useEnergyLossInModels = nullptr;
 	G4UIcmdWithAnInteger* p_noOfBetaSteps = nullptr;
+	G4UIcmdWithADouble* p_betaGridTolerance = nullptr;
 	G4UIcmdWithAnInteger* p_modelVerboseLevel = nullptr;
+	G4UIcommand* p_useAliasSampler = nullptr;
+	G4UIcmdWithABool* p_useRejectionSampling = nullptr;
+	G4UIcmdWithABool* p_useExactIntegration = nullptr;
+	G4UIcmdWithAnInteger* p_noOfRIndexGridNodes = nullptr;
 	G4UIcommand* p_printPhysicsVector = nullptr;
+	G4UIcommand* p_validatePhysicsTables = nullptr;
+	G4UIcmdWithAnInteger* p_usePhotonPool = nullptr;
+	G4UIcommand* p_forceEmissionTo = nullptr;
+	G4UIcommand* p_useCounterBasedRNG = nullptr;
+	//removes and rebuilds physics tables of G4BaseChR_Model (after changing beta-grid parameters or the sampling method)
+	void RebuildBaseChRPhysicsTables() const;
 };
 
 #endif // !G4CherenkovProcess_Messenger_hh
\ No newline at end of file
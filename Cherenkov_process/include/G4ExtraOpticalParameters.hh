@@ -18,6 +18,19 @@ volumes solves the problem in case of parametrized volumes). Also, the flag
 'm_exoticRIndex' is essential for using exotic refractive indices for
 Cherenkov radiation. Please, don't manually change the flag, but use the
 UI commands instead!
+
+G4CherenkovProcess doesn't read G4CherenkovMatData on every step, but it
+resolves it (see G4ChRResolvedOptics.hh). Therefore, after changing any
+G4CherenkovMatData, IncrementChRMatDataGeneration must be called (the UI
+commands do it), so the descriptors are resolved again.
+
+The thinning factor k (weighted photon thinning) can be set globally or for
+a specific logical volume (m_thinningFactor of G4CherenkovMatData, 0 means
+that the global value is used). With k > 1, Cherenkov models emit on average
+k times fewer photons, while each of them carries the weight k (see
+G4Track::GetWeight), i.e., the expected (weighted) photon yield and spectrum
+are not changed, only their variance is larger. Users' detectors must sum
+weights instead of counting photons.
 */
 
 #pragma once
@@ -32,6 +45,8 @@ UI commands instead!
 #include "G4ThinTargetChR_Model.hh"
 //std:: headers
 #include <memory>
+#include <atomic>
+#include <cstdint>
 #include <unordered_map>
 #include <iostream>
 #include <iomanip>
@@ -51,6 +66,7 @@ UI commands instead!
 //=======End of hashing of G4LogicalVolume*=======
 
 class G4ExtraOpticalParameters_Messenger;
+class G4CherenkovProcess;
 struct G4CherenkovMatData;
 
 class G4ExtraOpticalParameters final {
@@ -69,21 +85,35 @@ public:
 	//using the previous is user's responsibility, i.e., if rebuilding geometry, one should clear the map (remove const)
 	void ScanAndAddUnregisteredLV();
 	void PrintChRMatData(const G4LogicalVolume* aLV = nullptr) const;
+
+	//=======Inlines around the G4CherenkovMatData generation=======
+	inline static void IncrementChRMatDataGeneration();
+	[[nodiscard]] inline static std::uint64_t GetChRMatDataGeneration();
+
+	//=======Inlines around the thinning factor=======
+	// used for logical volumes with m_thinningFactor == 0; 1 - no thinning
+	inline void SetThinningFactor(const unsigned short);
+	[[nodiscard]] inline unsigned short GetThinningFactor() const;
+	// the thinning factor that is used for a logical volume
+	[[nodiscard]] inline unsigned short GetThinningFactor(const G4CherenkovMatData&) const;
 private:
 	G4ExtraOpticalParameters();
+	static std::atomic<std::uint64_t> m_ChRMatDataGeneration;
 	G4ExtraOpticalParameters_Messenger* p_extraOpticalParameters_Messenger = nullptr;
 	std::unordered_map<const G4LogicalVolume*, dataType/*, G4LogicalHasher, G4LogicalCompare*/> m_ChRMatData;
+	unsigned short m_thinningFactor = 1;
 };
 
 // To change m_exoticRIndex use the UI command; m_executeModel can be changed manually as well
 struct G4CherenkovMatData {
 	friend G4ExtraOpticalParameters;
 	friend G4ThinTargetChR_Model;
+	friend G4CherenkovProcess;
 	friend G4ExtraOpticalParameters_Messenger;
 public:
 	explicit G4CherenkovMatData(const size_t execModel = 0)
 		: m_executeModel(execModel), m_halfThickness(-1000.), m_exoticRIndex(false),
-		m_exoticFlagInital(false), m_minAxis(255) {}
+		m_exoticFlagInital(false), m_minAxis(255), m_thinningFactor(0) {}
 	~G4CherenkovMatData() { delete p_middlePoint; }
 
 	// G4CherenkovProcess model ID that will be executed
@@ -96,6 +126,7 @@ public:
 	[[nodiscard]] inline G4bool GetExoticRIndex() const;
 	[[nodiscard]] inline G4bool GetExoticInitialFlag() const;
 	[[nodiscard]] inline unsigned char GetMinAxis() const;
+	[[nodiscard]] inline unsigned short GetThinningFactor() const;
 private:
 	//only friends may access
 	G4ThreeVector* p_middlePoint = nullptr;
@@ -105,8 +136,9 @@ private:
 	G4bool m_exoticRIndex;
 	G4bool m_exoticFlagInital;
 	unsigned char m_minAxis; // 0 - x min; 1 - y min; 2 - z min; >2 fail
+	unsigned short m_thinningFactor; // 0 - the global thinning factor is used
 	// most of the private members are needed only for G4ThinTargetChR_Model
-	// 5 wasted bytes on x64
+	// 3 wasted bytes on x64
 };
 
 //=======Inlines around m_ChRMatData=======
@@ -148,6 +180,31 @@ const std::unordered_map<const G4LogicalVolume*, G4CherenkovMatData>& G4ExtraOpt
 	return m_ChRMatData;
 }
 
+//=======Inlines around the G4CherenkovMatData generation=======
+
+void G4ExtraOpticalParameters::IncrementChRMatDataGeneration() {
+	m_ChRMatDataGeneration.fetch_add(1, std::memory_order_acq_rel);
+}
+
+std::uint64_t G4ExtraOpticalParameters::GetChRMatDataGeneration() {
+	return m_ChRMatDataGeneration.load(std::memory_order_acquire);
+}
+
+//=======Inlines around the thinning factor=======
+
+void G4ExtraOpticalParameters::SetThinningFactor(const unsigned short value) {
+	m_thinningFactor = value;
+	IncrementChRMatDataGeneration();
+}
+
+unsigned short G4ExtraOpticalParameters::GetThinningFactor() const {
+	return m_thinningFactor;
+}
+
+unsigned short G4ExtraOpticalParameters::GetThinningFactor(const G4CherenkovMatData& aMatData) const {
+	return aMatData.m_thinningFactor ? aMatData.m_thinningFactor : m_thinningFactor;
+}
+
 //=======Get inlines for G4CherenkovMatData=======
 G4ThreeVector G4CherenkovMatData::GetMiddlePointVec() const {
 	if (p_middlePoint)
@@ -167,5 +224,8 @@ G4bool G4CherenkovMatData::GetExoticInitialFlag() const {
 unsigned char G4CherenkovMatData::GetMinAxis() const {
 	return m_minAxis;
 }
+unsigned short G4CherenkovMatData::GetThinningFactor() const {
+	return m_thinningFactor;
+}
 
 #endif // !G4ExtraOpticalParameters_hh
\ No newline at end of file
@@ -29,6 +29,7 @@ private:
 	G4UIcommand* p_executeModel = nullptr;
 	G4UIcommand* p_exoticRIndex = nullptr;
 	G4UIcommand* p_printChRMatData = nullptr;
+	G4UIcommand* p_thinningFactor = nullptr;
 };
 
 #endif // !G4ExtraOpticalParameters_Messenger_hh
\ No newline at end of file
@@ -30,7 +30,7 @@ public:
 	G4StandardChR_Model(G4StandardChR_Model&&) /*noexcept*/ = delete;
 	G4StandardChR_Model& operator=(G4StandardChR_Model&&) /*noexcept*/ = delete;
 
-	[[nodiscard]] virtual G4VParticleChange* PostStepModelDoIt(const G4Track&, const G4Step&, const G4CherenkovMatData&) override;
+	[[nodiscard]] virtual G4VParticleChange* PostStepModelDoIt(const G4Track&, const G4Step&, const G4ChRResolvedOptics&) override;
 	virtual void DumpModelInfo() const override;
 };
 
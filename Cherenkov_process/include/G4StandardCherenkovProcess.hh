@@ -26,15 +26,17 @@ The process is loaded through the G4OpticalPhysics_option1 class
 //G4 headers
 #include "G4VDiscreteProcess.hh"
 //...
-#include "G4ChRPhysicsTableData.hh"
+#include "G4ChRPhysicsTableService.hh"
+#include "G4ChRPhotonBatch.hh"
+//std:: headers
+#include <cstdint>
 
 class G4StandardChRProcess_Messenger;
+class G4LogicalVolume;
 
 class G4StandardCherenkovProcess : public G4VDiscreteProcess {
 	friend G4StandardChRProcess_Messenger;
 public:
-	using G4ChRPhysicsTableVector = std::vector<G4ChRPhysTableData>;
-
 	G4StandardCherenkovProcess(const G4String& name = "StandardCherenkov");
 	virtual ~G4StandardCherenkovProcess() override;
 	G4StandardCherenkovProcess(const G4StandardCherenkovProcess&) = delete;
@@ -48,56 +50,45 @@ public:
 	[[nodiscard]] virtual G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&) override;
 	[[nodiscard]] virtual G4double MinPrimaryEnergy(const G4ParticleDefinition*, const G4Material*) override;
 	virtual void BuildPhysicsTable(const G4ParticleDefinition&) override;
+	// binary files (see G4ChRPhysicsTableCache.hh) to skip the integration when restarting with the same materials
+	virtual G4bool StorePhysicsTable(const G4ParticleDefinition*, const G4String& directory, G4bool ascii = false) override;
+	virtual G4bool RetrievePhysicsTable(const G4ParticleDefinition*, const G4String& directory, G4bool ascii = false) override;
 	virtual void DumpInfo() const override;
 	virtual void ProcessDescription(std::ostream& outStream = std::cout) const override;
-
-	static void PrintChRPhysDataVec(const unsigned char printLevel = 0, const G4Material* aMaterial = nullptr);
-	// aMaterial == nullptr -> prints physics tables for all registered materials
-	// aMaterial == someMaterial -> prints physics tables for a someMaterial
-	// printLevel == 0 -> print only basic available information about registered physics tables
-	// printLevel == 1 -> print standard + p_valuesCDF values
-	// printLevel >= 2 -> print all available information about registered physics tables
 	
 	//=======Set inlines=======
-	inline static unsigned int SetNoOfBetaSteps(const unsigned int);
 	inline void SetUseEnergyLoss(const G4bool);
 	//=======Get inlines=======
-	[[nodiscard]] inline static unsigned int GetNoOfBetaSteps();
 	[[nodiscard]] inline G4bool GetUseEnergyLoss() const;
 protected:
 	[[nodiscard]] virtual G4double CalculateAverageNumberOfPhotons(const G4double aCharge, const G4double betaValue, const size_t materialID);
 	virtual G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*) override { return -1; }; //it was pure virtual
 private:
-	static G4ChRPhysicsTableVector m_ChRPhysDataVec;
-	static unsigned int m_noOfBetaSteps;
+	// weighted photon thinning (see G4ExtraOpticalParameters.hh); cached for the last logical volume
+	[[nodiscard]] unsigned short FindThinningFactor(const G4LogicalVolume*);
+
 	//=======Member variables=======
+	// tables published by G4ChRPhysicsTableService, updated at the beginning of each step
+	G4ChRPhysicsTableSnapshot m_ChRPhysDataSnapshot;
+	G4ChRPhotonBatch m_photonBatch; // reused between steps
 	G4ParticleChange* p_particleChange = nullptr;
 	G4StandardChRProcess_Messenger* p_ChRProcessMessenger = nullptr;
+	const G4LogicalVolume* p_thinningLV = nullptr;
+	std::uint64_t m_thinningGeneration = 0;
+	unsigned short m_thinningFactor = 1;
 	G4bool m_useEnergyLoss;
-	// 7 wasted bytes...
+	// 5 wasted bytes...
 	//==============================
-	static G4bool AddExoticRIndexPhysicsTable(const size_t materialID, G4bool forceExoticFlag = false);
-	static void RemoveExoticRIndexPhysicsTable(const size_t materialID);
 };
 
 //=======Set inlines=======
 
-unsigned int G4StandardCherenkovProcess::SetNoOfBetaSteps(const unsigned int value) {
-	unsigned int temp = m_noOfBetaSteps;
-	m_noOfBetaSteps = value;
-	return temp;
-}
-
 void G4StandardCherenkovProcess::SetUseEnergyLoss(const G4bool value) {
 	m_useEnergyLoss = value;
 }
 
 //=======Get inlines=======
 
-unsigned int G4StandardCherenkovProcess::GetNoOfBetaSteps() {
-	return m_noOfBetaSteps;
-}
-
 G4bool G4StandardCherenkovProcess::GetUseEnergyLoss() const {
 	return m_useEnergyLoss;
 }
@@ -25,6 +25,7 @@ Read the "DumpModelInfo" method
 class G4VPhysicalVolume;
 class G4AffineTransform;
 class G4Box;
+struct G4CherenkovMatData;
 
 class G4ThinTargetChR_Model : public G4BaseChR_Model {
 public:
@@ -36,7 +37,7 @@ public:
 	G4ThinTargetChR_Model(G4ThinTargetChR_Model&&) /*noexcept*/ = delete;
 	G4ThinTargetChR_Model& operator=(G4ThinTargetChR_Model&&) /*noexcept*/ = delete;
 
-	[[nodiscard]] virtual G4VParticleChange* PostStepModelDoIt(const G4Track&, const G4Step&, const G4CherenkovMatData&) override;
+	[[nodiscard]] virtual G4VParticleChange* PostStepModelDoIt(const G4Track&, const G4Step&, const G4ChRResolvedOptics&) override;
 	virtual void DumpModelInfo() const override;
 	virtual void BuildModelPhysicsTable(const G4ParticleDefinition&) override;
 private:
@@ -47,12 +48,20 @@ private:
 			const G4ThreeVector& localMiddlePoint,
 			const G4ThreeVector& localDirection,
 			const G4ThreeVector& localPrePoint,
-			const G4CherenkovMatData& aChRMatData) const;
+			const G4ChRResolvedOptics& theOptics) const;
 	G4double CalculateGaussSigmaDistance(
 			const G4ThreeVector& entryPoint,
 			const G4ThreeVector& exitPoint,
 			const G4ThreeVector& photonDirection,
-			const G4CherenkovMatData& matData) const;
+			const G4ChRResolvedOptics& theOptics) const;
+	// the margin of a cone (towards localAxis) for the smearing of photon i of m_photonBatch; 0 if it's not smeared
+	G4double CalculateConeMargin(
+			const G4ThreeVector& entryPoint,
+			const G4ThreeVector& exitPoint,
+			const G4ThreeVector& localAxis,
+			const size_t i,
+			const G4double theCosAngle,
+			const G4ChRResolvedOptics& theOptics) const;
 	void SetBoxPhysicsTableParameters(G4CherenkovMatData&, const G4ThreeVector&) const;
 };
 
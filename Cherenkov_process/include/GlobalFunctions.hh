@@ -12,6 +12,7 @@
 
 #include "globals.hh"
 #include "stdexcept"
+#include <functional>
 
 class G4VPhysicalVolume;
 class G4AffineTransform;
@@ -71,4 +72,11 @@ struct no_mother_physical_volume : std::logic_error {
 // Still, I believe that should be solvable by including operator* between G4AffineTransform
 // and G4ThreeVector. That way, one can use different ordering of the two.
 
+// Executes aTask(0) ... aTask(noOfTasks - 1) on the Geant4 task pool (PTL) and waits for all
+// of them to finish. Each task should only write its own data (e.g., the i-th element of a
+// preallocated vector), while the order of publishing results is left to the caller.
+// If there's no initialized thread pool (e.g., G4RunManager or G4MTRunManager are used), or the
+// function is called from a worker thread, tasks are executed serially in the calling thread
+void G4ExecuteInTaskPool(const size_t noOfTasks, const std::function<void(const size_t)>& aTask);
+
 #endif // !SomeGlobalNamespace_hh
\ No newline at end of file
@@ -0,0 +1,155 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+//G4 headers
+#include "G4ChRForcedEmission.hh"
+#include "G4ChRResolvedOptics.hh"
+#include "GlobalFunctions.hh"
+#include "G4Step.hh"
+#include "G4VTouchable.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4VSolid.hh"
+#include "G4VisExtent.hh"
+#include "G4AffineTransform.hh"
+#include "G4PhysicalConstants.hh"
+#include "geomdefs.hh"
+//std:: headers
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+//=========public G4ChRForcedEmission:: methods=========
+
+G4ChRForcedEmission::G4ChRForcedEmission(const G4String& targetName, const G4double outsideRIndex)
+: m_targetName(targetName), m_outsideRIndex(outsideRIndex) {}
+
+G4bool G4ChRForcedEmission::Resolve() {
+	const G4VPhysicalVolume* aTarget = G4PhysicalVolumeStore::GetInstance()->GetVolume(m_targetName, false);
+	if (!aTarget) {
+		if (!m_wasWarned) {
+			std::ostringstream msg;
+			msg << "There's no physical volume " << std::quoted(m_targetName) << ", so Cherenkov photons are not directed towards it!\n";
+			G4Exception("G4ChRForcedEmission::Resolve", "WE_ChRForcedEmission01", JustWarning, msg);
+			m_wasWarned = true;
+		}
+		return false;
+	}
+	G4AffineTransform aTransform;
+	try {
+		aTransform = GetLocalToGlobalTransformOfPhysicalVolume(aTarget);
+	}
+	catch (const no_mother_physical_volume& err) {
+		if (!m_wasWarned) {
+			std::ostringstream msg;
+			msg << err.what() << "\nThe position of " << std::quoted(m_targetName) << " is unknown, so Cherenkov photons are not directed towards it!\n";
+			G4Exception("G4ChRForcedEmission::Resolve", "WE_ChRForcedEmission02", JustWarning, msg);
+			m_wasWarned = true;
+		}
+		return false;
+	}
+	const G4VisExtent anExtent = aTarget->GetLogicalVolume()->GetSolid()->GetExtent();
+	m_targetCenter = aTransform.TransformPoint(anExtent.GetExtentCenter());
+	for (size_t i = 0; i < m_targetCorners.size(); i++) {
+		const G4ThreeVector aLocalCorner{
+			(i & 1) ? anExtent.GetXmax() : anExtent.GetXmin(),
+			(i & 2) ? anExtent.GetYmax() : anExtent.GetYmin(),
+			(i & 4) ? anExtent.GetZmax() : anExtent.GetZmin() };
+		m_targetCorners[i] = aTransform.TransformPoint(aLocalCorner);
+	}
+	m_isResolved = true;
+	return true;
+}
+
+G4ChRExitPlane G4ChRForcedEmission::FindExitPlane(const G4Step& aStep, const G4ChRResolvedOptics& theOptics) const {
+	G4ChRExitPlane anExitPlane;
+	const G4StepPoint* preStepPoint = aStep.GetPreStepPoint();
+	const G4VTouchable* aTouchable = preStepPoint->GetTouchable();
+	const G4AffineTransform aTransform{ aTouchable->GetRotation(), aTouchable->GetTranslation() }; // local to global
+	const G4AffineTransform inverseTransform{ aTransform.Inverse() }; // global to local
+	const G4ThreeVector localTarget = inverseTransform.TransformPoint(m_targetCenter);
+
+	G4ThreeVector localExitPoint, localNormal;
+	if (theOptics.m_minAxis <= 2 && theOptics.m_halfThickness > 0.) {
+		// the thin-target slab, i.e., all layers of a layered volume, and not only the current one
+		G4ThreeVector localMiddlePoint{ 0., 0., 0. };
+		if (theOptics.p_middlePoint)
+			localMiddlePoint = inverseTransform.TransformPoint(*theOptics.p_middlePoint);
+		localNormal[theOptics.m_minAxis] = localTarget[theOptics.m_minAxis] < localMiddlePoint[theOptics.m_minAxis] ? -1. : 1.;
+		localExitPoint = localMiddlePoint + theOptics.m_halfThickness * localNormal;
+	}
+	else {
+		// the surface of the current solid; a plane is a good approximation only for flat faces
+		const G4ThreeVector localPoint = inverseTransform.TransformPoint(preStepPoint->GetPosition() + 0.5 * aStep.GetDeltaPosition());
+		const G4ThreeVector localDirection = (localTarget - localPoint).unit();
+		const G4VSolid* aSolid = aTouchable->GetVolume()->GetLogicalVolume()->GetSolid();
+		const G4double distance = aSolid->DistanceToOut(localPoint, localDirection);
+		if (distance == kInfinity)
+			return anExitPlane;
+		localExitPoint = localPoint + distance * localDirection;
+		localNormal = aSolid->SurfaceNormal(localExitPoint);
+	}
+	anExitPlane.m_point = aTransform.TransformPoint(localExitPoint);
+	anExitPlane.m_normal = aTransform.TransformAxis(localNormal).unit();
+	// the target must be in front of the exit face
+	anExitPlane.m_isValid = anExitPlane.m_normal.dot(m_targetCenter - anExitPlane.m_point) > 0.;
+	return anExitPlane;
+}
+
+G4bool G4ChRForcedEmission::FindCone(const G4ThreeVector& anEmissionPoint, const G4double RIndex, const G4ChRExitPlane& anExitPlane,
+	G4ThreeVector& coneAxis, G4double& coneHalfAngle) const {
+	if (!anExitPlane.m_isValid)
+		return false;
+	const G4ThreeVector& theNormal = anExitPlane.m_normal;
+	// the distance of the emission point from the exit face (photons are emitted inside, so it's not negative)
+	const G4double depth = std::max((anExitPlane.m_point - anEmissionPoint).dot(theNormal), 0.);
+	// Snell's law: sin(thetaInside) = relativeRIndex * sin(thetaOutside)
+	const G4double relativeRIndex = m_outsideRIndex / RIndex;
+
+	G4ThreeVector outsideDirection = (m_targetCenter - anEmissionPoint).unit();
+	G4double cosOutside = outsideDirection.dot(theNormal);
+	if (cosOutside <= 0.)
+		return false;
+	G4ThreeVector anExitPoint = anEmissionPoint + (depth / cosOutside) * outsideDirection;
+	G4double cosInside = 1.;
+	for (unsigned char i = 0; i < m_noOfIterations; i++) {
+		outsideDirection = (m_targetCenter - anExitPoint).unit();
+		cosOutside = outsideDirection.dot(theNormal);
+		if (cosOutside <= 0.)
+			return false;
+		// the tangential component of the direction is scaled, while the normal one keeps the direction a unit vector
+		const G4ThreeVector tangential = relativeRIndex * (outsideDirection - cosOutside * theNormal);
+		const G4double sin2Inside = tangential.mag2();
+		if (sin2Inside >= 1.)
+			return false; // no direction inside is refracted into outsideDirection (m_outsideRIndex > RIndex)
+		cosInside = std::sqrt(1. - sin2Inside);
+		coneAxis = tangential + cosInside * theNormal;
+		anExitPoint = anEmissionPoint + (depth / cosInside) * coneAxis;
+	}
+
+	// the largest angle between outsideDirection and the corners of the target box
+	G4double minCos = 1.;
+	for (const G4ThreeVector& aCorner : m_targetCorners) {
+		const G4ThreeVector toCorner = aCorner - anExitPoint;
+		const G4double cornerDistance = toCorner.mag();
+		if (cornerDistance <= 0.)
+			continue;
+		minCos = std::min(minCos, toCorner.dot(outsideDirection) / cornerDistance);
+	}
+	if (minCos <= 0.) {
+		// the exit point is (almost) inside the target box, so any direction can reach it
+		coneHalfAngle = CLHEP::pi;
+		return true;
+	}
+	// dThetaInside / dThetaOutside in the plane of incidence and around the normal
+	const G4double magnification = std::max(relativeRIndex * cosOutside / cosInside, relativeRIndex);
+	coneHalfAngle = std::min(std::acos(minCos) * magnification, CLHEP::pi);
+	return true;
+}
\ No newline at end of file
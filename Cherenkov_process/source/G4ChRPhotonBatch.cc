@@ -0,0 +1,339 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+//G4 headers
+#include "G4ChRPhotonBatch.hh"
+#include "G4ParticleChange.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4Track.hh"
+#include "G4Step.hh"
+//std:: headers
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+//=========public G4ChREnergySampler:: methods=========
+
+G4double G4ChREnergySampler::SampleEnergy(G4ChRRandomBuffer& aRandomBuffer, G4double& sampledRI, G4double& cosTheta) {
+	const G4ChRPhysTableData& physData = *p_physData;
+	G4double sampledEnergy;
+	while (true) {
+		const G4double rand = aRandomBuffer.Flat();
+		switch (m_mode) {
+		case G4ChREnergySamplingMode::AboveThreshold:
+			sampledEnergy = physData.SampleEnergyAboveThreshold(m_beta, m_thresholdEnergy, rand);
+			break;
+		case G4ChREnergySamplingMode::AliasTable:
+			sampledEnergy = physData.SampleEnergyFromAliasTable(m_betaID, rand, aRandomBuffer.Flat());
+			break;
+		case G4ChREnergySamplingMode::CDF:
+			sampledEnergy = physData.SampleEnergyFromCDF(p_CDFRow, rand);
+			break;
+		default: /*G4ChREnergySamplingMode::Uniform*/
+			sampledEnergy = m_minEnergy + rand * (m_maxEnergy - m_minEnergy);
+		}
+		sampledRI = physData.HasUniformRIndexGrid() ? physData.GetRIndexValue(sampledEnergy) : p_RIndex->Value(sampledEnergy);
+		cosTheta = 1. / (sampledRI * m_beta); //might give > 1. for strange n(E) functions
+		if ((1.0 - cosTheta) * (1.0 + cosTheta) > 0.)
+			return sampledEnergy;
+		//the following 'if' is to prevent bad distributions if the user modified an almost non-exotic RIndex
+		if (m_mode == G4ChREnergySamplingMode::Uniform && m_adaptMinEnergy)
+			m_minEnergy = sampledEnergy;
+	}
+}
+
+//=========public G4ChRPhotonBatch:: methods=========
+
+void G4ChRPhotonBatch::Resize(const size_t noOfPhotons) {
+	// std::vector::resize never releases memory, so capacities only grow
+	m_energy.resize(noOfPhotons);
+	m_RIndex.resize(noOfPhotons);
+	m_cosTheta.resize(noOfPhotons);
+	m_sinTheta.resize(noOfPhotons);
+	m_phi.resize(noOfPhotons);
+	m_cosPhi.resize(noOfPhotons);
+	m_sinPhi.resize(noOfPhotons);
+	m_stepFraction.resize(noOfPhotons);
+	m_weight.resize(noOfPhotons);
+	m_streamID.resize(noOfPhotons);
+	m_coneAxisX.resize(noOfPhotons);
+	m_coneAxisY.resize(noOfPhotons);
+	m_coneAxisZ.resize(noOfPhotons);
+	m_coneHalfAngle.resize(noOfPhotons);
+	m_coneMargin.resize(noOfPhotons);
+	m_momentumX.resize(noOfPhotons);
+	m_momentumY.resize(noOfPhotons);
+	m_momentumZ.resize(noOfPhotons);
+	m_polarizationX.resize(noOfPhotons);
+	m_polarizationY.resize(noOfPhotons);
+	m_polarizationZ.resize(noOfPhotons);
+	m_noOfPhotons = noOfPhotons;
+}
+
+void G4ChRPhotonBatch::Generate(G4ChREnergySampler& aSampler, const size_t noOfPhotons) {
+	Resize(noOfPhotons);
+	G4double* __restrict energy = m_energy.data();
+	G4double* __restrict RIndex = m_RIndex.data();
+	G4double* __restrict cosTheta = m_cosTheta.data();
+	G4double* __restrict phi = m_phi.data();
+	G4double* __restrict stepFraction = m_stepFraction.data();
+	m_isWeighted = false;
+	m_hasTargetCones = false;
+
+	if (m_randomBuffer.IsCounterBased()) {
+		GenerateCounterBased(aSampler, noOfPhotons);
+		m_generatedEnergy = std::accumulate(energy, energy + noOfPhotons, 0.);
+		return;
+	}
+
+	// all numbers of the step in a single engine call (unless energies are rejected)
+	const size_t noOfEnergyRands = aSampler.m_mode == G4ChREnergySamplingMode::AliasTable ? 2 : 1;
+	m_randomBuffer.Prefetch((noOfEnergyRands + 2) * noOfPhotons);
+
+	// energies - the only part with branches (rejections and table searches)
+	for (size_t i = 0; i < noOfPhotons; ++i)
+		energy[i] = aSampler.SampleEnergy(m_randomBuffer, RIndex[i], cosTheta[i]);
+	m_generatedEnergy = std::accumulate(energy, energy + noOfPhotons, 0.);
+
+	// the following loops have no branches, so they are vectorized
+	G4ChRPhotonKernels::ComputeSinTheta(cosTheta, m_sinTheta.data(), noOfPhotons);
+
+	const G4double* rands = m_randomBuffer.Take(noOfPhotons);
+	for (size_t i = 0; i < noOfPhotons; ++i)
+		phi[i] = CLHEP::twopi * rands[i];
+	ComputePhiColumns();
+
+	//The following seems like a very expensive way to change rand distribution
+	//However, the idea might be correct for very low energies, i.e.,
+	//more photons are emitted from around preStep than around postStep.
+	//Any suggestions?
+	//=================================================================
+	//double beta1 = preStepPoint->GetBeta();
+	//double beta2 = postStepPoint->GetBeta();
+	//double meanNumberOfPhotons1 = CalculateAverageNumberOfPhotons(charge, beta1, aMaterial);
+	//double meanNumberOfPhotons2 = CalculateAverageNumberOfPhotons(charge, beta2, aMaterial);
+	//double numberOfPhotons, N;
+	//do {
+	//	rand = G4UniformRand();
+	//	numberOfPhotons = meanNumberOfPhotons1 - rand * (meanNumberOfPhotons1 - meanNumberOfPhotons2);
+	//	N = G4UniformRand() * std::max(meanNumberOfPhotons1, meanNumberOfPhotons2);
+	//	// Loop checking, 07-Aug-2015, Vladimir Ivanchenko
+	//} while (N > numberOfPhotons);
+	//=================================================================
+	//More or less, the following line can replace the commented part...
+	//however, the distribution remains uniform no matter what
+	rands = m_randomBuffer.Take(noOfPhotons);
+	for (size_t i = 0; i < noOfPhotons; ++i)
+		stepFraction[i] = rands[i];
+}
+
+void G4ChRPhotonBatch::GenerateCounterBased(G4ChREnergySampler& aSampler, const size_t noOfPhotons) {
+	G4double* __restrict energy = m_energy.data();
+	G4double* __restrict RIndex = m_RIndex.data();
+	G4double* __restrict cosTheta = m_cosTheta.data();
+	G4double* __restrict phi = m_phi.data();
+	std::uint32_t* __restrict streamID = m_streamID.data();
+
+	// each photon has its own stream, so photons could be generated in any order (or in parallel)
+	for (size_t i = 0; i < noOfPhotons; ++i) {
+		streamID[i] = static_cast<std::uint32_t>(i);
+		m_randomBuffer.SelectStream(streamID[i], 2);
+		energy[i] = aSampler.SampleEnergy(m_randomBuffer, RIndex[i], cosTheta[i]);
+	}
+	G4ChRPhotonKernels::ComputeSinTheta(cosTheta, m_sinTheta.data(), noOfPhotons);
+
+	// draws 0 and 1 of all streams, i.e., phi and the step fraction
+	m_randomBuffer.FillStreams(phi, m_stepFraction.data(), noOfPhotons, 0);
+	for (size_t i = 0; i < noOfPhotons; ++i)
+		phi[i] *= CLHEP::twopi;
+	ComputePhiColumns();
+}
+
+void G4ChRPhotonBatch::BuildDirections(const G4ChRRotationFrame& aFrame, const G4bool withPolarization) {
+	G4ChRPhotonKernels::BuildDirections(aFrame, m_cosTheta.data(), m_sinTheta.data(), m_cosPhi.data(), m_sinPhi.data(), m_noOfPhotons,
+		{ m_momentumX.data(), m_momentumY.data(), m_momentumZ.data() },
+		withPolarization ? G4ChRDirectionColumns{ m_polarizationX.data(), m_polarizationY.data(), m_polarizationZ.data() } : G4ChRDirectionColumns{});
+}
+
+void G4ChRPhotonBatch::BiasPhi(const G4ChRAngularBiasing& aBiasing, const G4ChRRotationFrame& primaryFrame, const G4bool useConeMargins) {
+	G4double* __restrict phi = m_phi.data();
+	G4double* __restrict weight = m_weight.data();
+	if (aBiasing.UsesPhiWindow()) {
+		// uniform phi in [0, 2pi) is mapped to the window, so no random number is drawn again;
+		// all photons of the step end up in the window, so each one stands for m_deltaPhi / 2pi photons
+		const G4double phiMin = aBiasing.m_phiCenter - 0.5 * aBiasing.m_deltaPhi;
+		const G4double phiScale = aBiasing.m_deltaPhi / CLHEP::twopi;
+		const G4double theWeight = phiScale;
+		for (size_t i = 0; i < m_noOfPhotons; ++i) {
+			phi[i] = phiMin + phiScale * phi[i];
+			weight[i] = theWeight;
+		}
+	}
+	else if (aBiasing.UsesGlobalCone()) {
+		const G4ThreeVector coneAxis = primaryFrame.ApplyInverse(aBiasing.m_coneAxis);
+		const G4double cosAlpha = std::cos(aBiasing.m_coneHalfAngle);
+		const G4double sinThetaAxis = std::sqrt(coneAxis.x() * coneAxis.x() + coneAxis.y() * coneAxis.y());
+		const G4double phiAxis = sinThetaAxis > 0. ? std::atan2(coneAxis.y(), coneAxis.x()) : 0.;
+		size_t noOfKept = 0;
+		for (size_t i = 0; i < m_noOfPhotons; ++i) {
+			const G4double photonCosAlpha = useConeMargins ? std::cos(std::min(aBiasing.m_coneHalfAngle + m_coneMargin[i], CLHEP::pi)) : cosAlpha;
+			const G4double halfWidth = FindPhiHalfWidth(m_sinTheta[i], m_cosTheta[i], sinThetaAxis, coneAxis.z(), photonCosAlpha);
+			if (halfWidth <= 0.)
+				continue; // this theta never reaches the cone
+			phi[i] = phiAxis - halfWidth + phi[i] * (halfWidth / CLHEP::pi);
+			weight[i] = halfWidth / CLHEP::pi; // the probability of the interval without biasing
+			MovePhoton(i, noOfKept++);
+		}
+		m_noOfPhotons = noOfKept;
+	}
+	else
+		return;
+	m_isWeighted = true;
+	ComputePhiColumns();
+}
+
+void G4ChRPhotonBatch::FindTargetCones(const G4ChRForcedEmission& aForcedEmission, const G4ChRExitPlane& anExitPlane,
+	const G4ThreeVector& x0, const G4ThreeVector& deltaPosition) {
+	m_hasTargetCones = true;
+	size_t noOfKept = 0;
+	for (size_t i = 0; i < m_noOfPhotons; ++i) {
+		G4ThreeVector coneAxis;
+		G4double coneHalfAngle;
+		if (!aForcedEmission.FindCone(x0 + m_stepFraction[i] * deltaPosition, m_RIndex[i], anExitPlane, coneAxis, coneHalfAngle))
+			continue; // never reaches the target
+		m_coneAxisX[i] = coneAxis.x();
+		m_coneAxisY[i] = coneAxis.y();
+		m_coneAxisZ[i] = coneAxis.z();
+		m_coneHalfAngle[i] = coneHalfAngle;
+		m_coneMargin[i] = 0.;
+		MovePhoton(i, noOfKept++);
+	}
+	m_noOfPhotons = noOfKept;
+}
+
+void G4ChRPhotonBatch::BiasPhiToTargetCones(const G4ChRRotationFrame& primaryFrame) {
+	G4double* __restrict phi = m_phi.data();
+	G4double* __restrict weight = m_weight.data();
+	size_t noOfKept = 0;
+	for (size_t i = 0; i < m_noOfPhotons; ++i) {
+		const G4ThreeVector coneAxis = primaryFrame.ApplyInverse({ m_coneAxisX[i], m_coneAxisY[i], m_coneAxisZ[i] });
+		const G4double sinThetaAxis = std::sqrt(coneAxis.x() * coneAxis.x() + coneAxis.y() * coneAxis.y());
+		const G4double phiAxis = sinThetaAxis > 0. ? std::atan2(coneAxis.y(), coneAxis.x()) : 0.;
+		const G4double cosAlpha = std::cos(std::min(m_coneHalfAngle[i] + m_coneMargin[i], CLHEP::pi));
+		const G4double halfWidth = FindPhiHalfWidth(m_sinTheta[i], m_cosTheta[i], sinThetaAxis, coneAxis.z(), cosAlpha);
+		if (halfWidth <= 0.)
+			continue; // this theta never reaches the cone
+		phi[i] = phiAxis - halfWidth + phi[i] * (halfWidth / CLHEP::pi);
+		weight[i] = halfWidth / CLHEP::pi; // the probability of the interval without biasing (as in BiasPhi)
+		MovePhoton(i, noOfKept++);
+	}
+	m_noOfPhotons = noOfKept;
+	m_isWeighted = true;
+	ComputePhiColumns();
+}
+
+void G4ChRPhotonBatch::ApplyAcceptance(const G4ChRAngularBiasing* aBiasing, const G4ChRRotationFrame& primaryFrame) {
+	const G4bool usesThetaWindow = aBiasing && aBiasing->UsesThetaWindow();
+	const G4bool usesGlobalCone = aBiasing && aBiasing->UsesGlobalCone();
+	if (!usesThetaWindow && !usesGlobalCone && !m_hasTargetCones)
+		return;
+	const G4double cosThetaMax = usesThetaWindow ? std::cos(aBiasing->m_thetaMin) : 1.; // the larger cosine
+	const G4double cosThetaMin = usesThetaWindow ? std::cos(aBiasing->m_thetaMax) : -1.;
+	const G4ThreeVector coneAxis = usesGlobalCone ? primaryFrame.ApplyInverse(aBiasing->m_coneAxis) : G4ThreeVector{ 0., 0., 1. };
+	// the phi interval of BiasPhi is exact, so rounding errors must not remove photons at its edges
+	const G4double cosAlpha = usesGlobalCone ? std::cos(aBiasing->m_coneHalfAngle) - G4ChRRotationFrame::m_rotateUzTolerance : -2.;
+	size_t noOfKept = 0;
+	for (size_t i = 0; i < m_noOfPhotons; ++i) {
+		const G4double cosTheta = m_cosTheta[i];
+		if (usesThetaWindow && (cosTheta > cosThetaMax || cosTheta < cosThetaMin))
+			continue;
+		if (usesGlobalCone && m_sinTheta[i] * (m_cosPhi[i] * coneAxis.x() + m_sinPhi[i] * coneAxis.y()) + cosTheta * coneAxis.z() < cosAlpha)
+			continue;
+		if (m_hasTargetCones) {
+			const G4ThreeVector targetAxis = primaryFrame.ApplyInverse({ m_coneAxisX[i], m_coneAxisY[i], m_coneAxisZ[i] });
+			if (m_sinTheta[i] * (m_cosPhi[i] * targetAxis.x() + m_sinPhi[i] * targetAxis.y()) + cosTheta * targetAxis.z()
+				< std::cos(m_coneHalfAngle[i]) - G4ChRRotationFrame::m_rotateUzTolerance)
+				continue;
+		}
+		MovePhoton(i, noOfKept++);
+	}
+	m_noOfPhotons = noOfKept;
+}
+
+G4double G4ChRPhotonBatch::MaterializePhotons(const G4Track& aTrack, const G4Step& aStep, G4ParticleChange* aParticleChange,
+	const unsigned short thinningFactor) {
+	const G4StepPoint* preStepPoint = aStep.GetPreStepPoint();
+	const G4ThreeVector x0 = preStepPoint->GetPosition();
+	const G4ThreeVector deltaPosition = aStep.GetDeltaPosition();
+	const G4ThreeVector p0 = deltaPosition.unit();
+	const G4double t0 = preStepPoint->GetGlobalTime();
+	const G4double stepLength = aStep.GetStepLength();
+	const G4double preVelocity = preStepPoint->GetVelocity();
+	const G4double halfDeltaVelocity = (aStep.GetPostStepPoint()->GetVelocity() - preVelocity) * 0.5;
+	const G4TouchableHandle& aTouchableHandle = preStepPoint->GetTouchableHandle();
+	const G4int parentID = aTrack.GetTrackID();
+	// each photon stands for thinningFactor photons
+	const G4double photonWeight = aTrack.GetWeight() * thinningFactor;
+
+	// the momentum is still with respect to the coordinate system where the primary particle
+	// direction is aligned with the z axis, so it's rotated back to the global reference system
+	BuildDirections(G4ChRRotationFrame::FromDirection(p0), true);
+
+	for (size_t i = 0; i < m_noOfPhotons; ++i) {
+		const G4ParticleMomentum photonMomentum{ m_momentumX[i], m_momentumY[i], m_momentumZ[i] };
+		const G4ThreeVector photonPolarization{ m_polarizationX[i], m_polarizationY[i], m_polarizationZ[i] };
+		// Generate a new photon:
+		auto aCerenkovPhoton = new G4DynamicParticle{ G4OpticalPhoton::OpticalPhoton(), photonMomentum };
+
+		aCerenkovPhoton->SetPolarization(photonPolarization);
+		aCerenkovPhoton->SetKineticEnergy(m_energy[i]);
+
+		const G4double rand = m_stepFraction[i];
+		G4double delta = rand * stepLength;
+		G4double deltaTime = delta / (preVelocity + rand * halfDeltaVelocity);
+
+		G4double aSecondaryTime = t0 + deltaTime;
+		G4ThreeVector aSecondaryPosition{ x0 + rand * deltaPosition };
+
+		// Generate new G4Track object:
+		G4Track* aSecondaryTrack = new G4Track{ aCerenkovPhoton, aSecondaryTime, aSecondaryPosition };
+
+		aSecondaryTrack->SetTouchableHandle(aTouchableHandle);
+		aSecondaryTrack->SetParentID(parentID);
+		aSecondaryTrack->SetWeight(m_isWeighted ? photonWeight * m_weight[i] : photonWeight);
+		aParticleChange->AddSecondary(aSecondaryTrack);
+	}
+	// the end of the step - numbers are not kept for the next step (see G4ChRRandomBuffer.hh)
+	m_randomBuffer.Clear();
+	// the energy of all generated photons, i.e., it doesn't depend on biasing (removed photons are still emitted physically)
+	return m_generatedEnergy * thinningFactor;
+}
+
+//=========private G4ChRPhotonBatch:: methods=========
+
+G4double G4ChRPhotonBatch::FindPhiHalfWidth(const G4double sinTheta, const G4double cosTheta,
+	const G4double sinThetaAxis, const G4double cosThetaAxis, const G4double cosAlpha) {
+	// photon direction (sinTheta * cosPhi, sinTheta * sinPhi, cosTheta) is inside the cone if
+	// cos(phi - phiAxis) >= (cosAlpha - cosTheta * cosThetaAxis) / (sinTheta * sinThetaAxis)
+	const G4double sinProduct = sinTheta * sinThetaAxis;
+	const G4double cosProduct = cosTheta * cosThetaAxis;
+	if (sinProduct <= 0.)
+		return cosProduct >= cosAlpha ? CLHEP::pi : 0.;
+	const G4double cosHalfWidth = (cosAlpha - cosProduct) / sinProduct;
+	return cosHalfWidth <= -1. ? CLHEP::pi : (cosHalfWidth >= 1. ? 0. : std::acos(cosHalfWidth));
+}
+
+void G4ChRPhotonBatch::ComputePhiColumns() {
+	const G4double* __restrict phi = m_phi.data();
+	G4double* __restrict cosPhi = m_cosPhi.data();
+	G4double* __restrict sinPhi = m_sinPhi.data();
+	for (size_t i = 0; i < m_noOfPhotons; ++i) {
+		sinPhi[i] = std::sin(phi[i]);
+		cosPhi[i] = std::cos(phi[i]);
+	}
+}
\ No newline at end of file
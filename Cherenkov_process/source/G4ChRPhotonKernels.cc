@@ -0,0 +1,170 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+//G4 headers
+#include "G4ChRPhotonKernels.hh"
+#include "G4AffineTransform.hh"
+//std:: headers
+#include <cmath>
+
+#if !defined(G4ChR_NO_SIMD) && defined(__AVX2__)
+#define G4ChR_SIMD_AVX2
+#include <immintrin.h>
+#elif !defined(G4ChR_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define G4ChR_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+// a thin layer over intrinsics, so a single loop is written for both instruction sets
+#if defined(G4ChR_SIMD_AVX2)
+using G4ChRSimdVec = __m256d;
+static constexpr size_t o_simdWidth = 4;
+static inline G4ChRSimdVec SimdLoad(const G4double* p) { return _mm256_loadu_pd(p); }
+static inline void SimdStore(G4double* p, const G4ChRSimdVec a) { _mm256_storeu_pd(p, a); }
+static inline G4ChRSimdVec SimdSet(const G4double a) { return _mm256_set1_pd(a); }
+static inline G4ChRSimdVec SimdAdd(const G4ChRSimdVec a, const G4ChRSimdVec b) { return _mm256_add_pd(a, b); }
+static inline G4ChRSimdVec SimdSub(const G4ChRSimdVec a, const G4ChRSimdVec b) { return _mm256_sub_pd(a, b); }
+static inline G4ChRSimdVec SimdMul(const G4ChRSimdVec a, const G4ChRSimdVec b) { return _mm256_mul_pd(a, b); }
+static inline G4ChRSimdVec SimdSqrt(const G4ChRSimdVec a) { return _mm256_sqrt_pd(a); }
+#elif defined(G4ChR_SIMD_SSE2)
+using G4ChRSimdVec = __m128d;
+static constexpr size_t o_simdWidth = 2;
+static inline G4ChRSimdVec SimdLoad(const G4double* p) { return _mm_loadu_pd(p); }
+static inline void SimdStore(G4double* p, const G4ChRSimdVec a) { _mm_storeu_pd(p, a); }
+static inline G4ChRSimdVec SimdSet(const G4double a) { return _mm_set1_pd(a); }
+static inline G4ChRSimdVec SimdAdd(const G4ChRSimdVec a, const G4ChRSimdVec b) { return _mm_add_pd(a, b); }
+static inline G4ChRSimdVec SimdSub(const G4ChRSimdVec a, const G4ChRSimdVec b) { return _mm_sub_pd(a, b); }
+static inline G4ChRSimdVec SimdMul(const G4ChRSimdVec a, const G4ChRSimdVec b) { return _mm_mul_pd(a, b); }
+static inline G4ChRSimdVec SimdSqrt(const G4ChRSimdVec a) { return _mm_sqrt_pd(a); }
+#endif
+
+//=========public G4ChRRotationFrame:: methods=========
+
+G4ChRRotationFrame G4ChRRotationFrame::FromDirection(const G4ThreeVector& p0) {
+	// the same cases as in G4ThreeVector::rotateUz
+	G4ChRRotationFrame aFrame{};
+	G4double* M = aFrame.m_matrix;
+	const G4double u1 = p0.x();
+	const G4double u2 = p0.y();
+	const G4double u3 = p0.z();
+	G4double up = u1 * u1 + u2 * u2;
+	if (up > 0.) {
+		up = std::sqrt(up);
+		M[0] = u1 * u3 / up; M[1] = -u2 / up; M[2] = u1;
+		M[3] = u2 * u3 / up; M[4] = u1 / up;  M[5] = u2;
+		M[6] = -up;          M[7] = 0.;       M[8] = u3;
+	}
+	else if (u3 < 0.) {
+		M[0] = -1.;
+		M[8] = -1.;
+	}
+	// else - the identity
+	return aFrame;
+}
+
+G4ChRRotationFrame G4ChRRotationFrame::Transformed(const G4AffineTransform& aTransform) const {
+	// the columns of the matrix are the images of the x, y and z axes
+	G4ChRRotationFrame aFrame{};
+	for (size_t j = 0; j < 3; j++) {
+		G4ThreeVector aColumn{ m_matrix[j], m_matrix[3 + j], m_matrix[6 + j] };
+		aTransform.ApplyAxisTransform(aColumn);
+		aFrame.m_matrix[j] = aColumn.x();
+		aFrame.m_matrix[3 + j] = aColumn.y();
+		aFrame.m_matrix[6 + j] = aColumn.z();
+	}
+	return aFrame;
+}
+
+//=========public G4ChRPhotonKernels:: methods=========
+
+void G4ChRPhotonKernels::ComputeSinTheta(const G4double* cosTheta, G4double* sinTheta, const size_t noOfPhotons) {
+	size_t i = 0;
+#if defined(G4ChR_SIMD_AVX2) || defined(G4ChR_SIMD_SSE2)
+	const G4ChRSimdVec one = SimdSet(1.);
+	for (; i + o_simdWidth <= noOfPhotons; i += o_simdWidth) {
+		const G4ChRSimdVec c = SimdLoad(cosTheta + i);
+		SimdStore(sinTheta + i, SimdSqrt(SimdMul(SimdSub(one, c), SimdAdd(one, c))));
+	}
+#endif
+	ComputeSinThetaScalar(cosTheta + i, sinTheta + i, noOfPhotons - i);
+}
+
+void G4ChRPhotonKernels::ComputeSinThetaScalar(const G4double* cosTheta, G4double* sinTheta, const size_t noOfPhotons) {
+	for (size_t i = 0; i < noOfPhotons; ++i)
+		sinTheta[i] = std::sqrt((1.0 - cosTheta[i]) * (1.0 + cosTheta[i]));
+}
+
+void G4ChRPhotonKernels::BuildDirections(const G4ChRRotationFrame& aFrame, const G4double* cosTheta, const G4double* sinTheta,
+	const G4double* cosPhi, const G4double* sinPhi, const size_t noOfPhotons,
+	G4ChRDirectionColumns momentum, G4ChRDirectionColumns polarization) {
+	size_t i = 0;
+#if defined(G4ChR_SIMD_AVX2) || defined(G4ChR_SIMD_SSE2)
+	const G4double* M = aFrame.m_matrix;
+	const G4ChRSimdVec m0 = SimdSet(M[0]), m1 = SimdSet(M[1]), m2 = SimdSet(M[2]);
+	const G4ChRSimdVec m3 = SimdSet(M[3]), m4 = SimdSet(M[4]), m5 = SimdSet(M[5]);
+	const G4ChRSimdVec m6 = SimdSet(M[6]), m7 = SimdSet(M[7]), m8 = SimdSet(M[8]);
+	const G4bool withPolarization = polarization.p_x != nullptr;
+	for (; i + o_simdWidth <= noOfPhotons; i += o_simdWidth) {
+		const G4ChRSimdVec cT = SimdLoad(cosTheta + i);
+		const G4ChRSimdVec sT = SimdLoad(sinTheta + i);
+		const G4ChRSimdVec cP = SimdLoad(cosPhi + i);
+		const G4ChRSimdVec sP = SimdLoad(sinPhi + i);
+
+		G4ChRSimdVec x = SimdMul(sT, cP);
+		G4ChRSimdVec y = SimdMul(sT, sP);
+		SimdStore(momentum.p_x + i, SimdAdd(SimdAdd(SimdMul(m0, x), SimdMul(m1, y)), SimdMul(m2, cT)));
+		SimdStore(momentum.p_y + i, SimdAdd(SimdAdd(SimdMul(m3, x), SimdMul(m4, y)), SimdMul(m5, cT)));
+		SimdStore(momentum.p_z + i, SimdAdd(SimdAdd(SimdMul(m6, x), SimdMul(m7, y)), SimdMul(m8, cT)));
+		if (!withPolarization)
+			continue;
+		x = SimdMul(cT, cP);
+		y = SimdMul(cT, sP);
+		SimdStore(polarization.p_x + i, SimdSub(SimdAdd(SimdMul(m0, x), SimdMul(m1, y)), SimdMul(m2, sT)));
+		SimdStore(polarization.p_y + i, SimdSub(SimdAdd(SimdMul(m3, x), SimdMul(m4, y)), SimdMul(m5, sT)));
+		SimdStore(polarization.p_z + i, SimdSub(SimdAdd(SimdMul(m6, x), SimdMul(m7, y)), SimdMul(m8, sT)));
+	}
+	if (i) {
+		momentum = { momentum.p_x + i, momentum.p_y + i, momentum.p_z + i };
+		if (withPolarization)
+			polarization = { polarization.p_x + i, polarization.p_y + i, polarization.p_z + i };
+	}
+#endif
+	BuildDirectionsScalar(aFrame, cosTheta + i, sinTheta + i, cosPhi + i, sinPhi + i, noOfPhotons - i, momentum, polarization);
+}
+
+void G4ChRPhotonKernels::BuildDirectionsScalar(const G4ChRRotationFrame& aFrame, const G4double* cosTheta, const G4double* sinTheta,
+	const G4double* cosPhi, const G4double* sinPhi, const size_t noOfPhotons,
+	G4ChRDirectionColumns momentum, G4ChRDirectionColumns polarization) {
+	const G4double* M = aFrame.m_matrix;
+	for (size_t i = 0; i < noOfPhotons; ++i) {
+		const G4double x = sinTheta[i] * cosPhi[i];
+		const G4double y = sinTheta[i] * sinPhi[i];
+		momentum.p_x[i] = M[0] * x + M[1] * y + M[2] * cosTheta[i];
+		momentum.p_y[i] = M[3] * x + M[4] * y + M[5] * cosTheta[i];
+		momentum.p_z[i] = M[6] * x + M[7] * y + M[8] * cosTheta[i];
+	}
+	if (!polarization.p_x)
+		return;
+	for (size_t i = 0; i < noOfPhotons; ++i) {
+		const G4double x = cosTheta[i] * cosPhi[i];
+		const G4double y = cosTheta[i] * sinPhi[i];
+		polarization.p_x[i] = M[0] * x + M[1] * y - M[2] * sinTheta[i];
+		polarization.p_y[i] = M[3] * x + M[4] * y - M[5] * sinTheta[i];
+		polarization.p_z[i] = M[6] * x + M[7] * y - M[8] * sinTheta[i];
+	}
+}
+
+const char* G4ChRPhotonKernels::GetInstructionSetName() {
+#if defined(G4ChR_SIMD_AVX2)
+	return "AVX2";
+#elif defined(G4ChR_SIMD_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+//G4 headers
+#include "G4ChRPhotonPool.hh"
+#include "G4ParticleChange.hh"
+#include "G4Track.hh"
+#include "G4DynamicParticle.hh"
+#include "G4Allocator.hh"
+#include "G4EventManager.hh"
+#include "G4Event.hh"
+//std:: headers
+#include <sstream>
+
+static G4ThreadLocal G4bool o_isEnabled = false;
+static G4ThreadLocal unsigned int o_pageFactor = 1; // already applied to the pools
+static G4ThreadLocal G4int o_eventID = -1;
+static G4ThreadLocal G4int o_maxNoOfSecondaries = 0; // in a step of the event o_eventID
+
+//=========public G4ChRPhotonPool:: methods=========
+
+void G4ChRPhotonPool::Enable(const unsigned int pageFactor, const unsigned char verboseLevel) {
+	o_isEnabled = true;
+	o_eventID = -1;
+	o_maxNoOfSecondaries = 0;
+	if (pageFactor <= 1 || o_pageFactor != 1) {
+		if (o_pageFactor != 1 && pageFactor != o_pageFactor) {
+			std::ostringstream msg;
+			msg << "Pages of photon pools on this thread have already been increased " << o_pageFactor
+				<< " times, and they cannot be changed again! The page factor " << pageFactor << " is ignored.\n";
+			G4Exception("G4ChRPhotonPool::Enable", "WE_ChRPhotonPool01", JustWarning, msg);
+		}
+		return;
+	}
+	o_pageFactor = pageFactor;
+	if (!aTrackAllocator())
+		aTrackAllocator() = new G4Allocator<G4Track>;
+	aTrackAllocator()->IncreasePageSize(pageFactor);
+	if (!pDynamicParticleAllocator())
+		pDynamicParticleAllocator() = new G4Allocator<G4DynamicParticle>;
+	if (pDynamicParticleAllocator()->GetNoPages() == 0)
+		pDynamicParticleAllocator()->IncreasePageSize(pageFactor);
+	else if (verboseLevel > 0) {
+		const char* msg = "G4DynamicParticle objects already exist on this thread, so their pool pages are not changed!\n";
+		G4Exception("G4ChRPhotonPool::Enable", "WE_ChRPhotonPool02", JustWarning, msg);
+	}
+	if (verboseLevel > 0)
+		std::cout << "G4ChRPhotonPool: G4Track pool pages - " << aTrackAllocator()->GetPageSize() << " bytes\n";
+}
+
+void G4ChRPhotonPool::Disable() {
+	// the storage of G4Allocator pools is owned by Geant4 (and shared with other users), so it's not released here
+	o_isEnabled = false;
+}
+
+G4bool G4ChRPhotonPool::IsEnabled() {
+	return o_isEnabled;
+}
+
+void G4ChRPhotonPool::SetNumberOfSecondaries(G4ParticleChange* aParticleChange, const G4int noOfPhotons) {
+	if (!o_isEnabled) {
+		aParticleChange->SetNumberOfSecondaries(noOfPhotons);
+		return;
+	}
+	const G4Event* anEvent = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+	const G4int eventID = anEvent ? anEvent->GetEventID() : -1;
+	if (eventID != o_eventID) {
+		o_eventID = eventID;
+		o_maxNoOfSecondaries = 0;
+	}
+	if (noOfPhotons > o_maxNoOfSecondaries)
+		o_maxNoOfSecondaries = noOfPhotons;
+	aParticleChange->SetNumberOfSecondaries(o_maxNoOfSecondaries);
+}
\ No newline at end of file
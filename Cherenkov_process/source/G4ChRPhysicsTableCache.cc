@@ -0,0 +1,216 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+//G4 headers
+#include "G4ChRPhysicsTableCache.hh"
+#include "G4AccessPhysicsVectors.hh"
+#include "G4Material.hh"
+#include "G4MaterialPropertiesTable.hh"
+//std:: headers
+#include <fstream>
+#include <iomanip>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+
+//FNV-1a (64-bit) is simple and good enough to distinguish refractive indices
+static constexpr std::uint64_t o_FNVOffsetBasis = 14695981039346656037ULL;
+static constexpr std::uint64_t o_FNVPrime = 1099511628211ULL;
+
+static void HashBytes(std::uint64_t& aHash, const void* data, const size_t noOfBytes) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < noOfBytes; i++) {
+		aHash ^= bytes[i];
+		aHash *= o_FNVPrime;
+	}
+}
+
+//=========public G4ChRPhysicsTableCache:: methods=========
+
+G4String G4ChRPhysicsTableCache::GetCacheFileName(const G4String& directory, const G4String& ownerName) {
+	G4String fileName = directory;
+	if (!fileName.empty() && fileName.back() != '/' && fileName.back() != '\\')
+		fileName += '/';
+	return fileName + "ChRPhysicsTables." + ownerName + ".bin";
+}
+
+std::uint64_t G4ChRPhysicsTableCache::GetMaterialTableKey(const size_t materialID, const unsigned int noOfBetaSteps,
+	const G4double betaGridTolerance, const G4bool exactIntegration, const G4bool exoticFlag) {
+	std::uint64_t aKey = o_FNVOffsetBasis;
+	const std::uint64_t keyParameters[3] = { noOfBetaSteps, exoticFlag ? 1ULL : 0ULL, exactIntegration ? 1ULL : 0ULL };
+	HashBytes(aKey, keyParameters, sizeof(keyParameters));
+	HashBytes(aKey, &betaGridTolerance, sizeof(betaGridTolerance));
+	const G4MaterialPropertiesTable* MPT = (*G4Material::GetMaterialTable())[materialID]->GetMaterialPropertiesTable();
+	if (!MPT)
+		return aKey;
+	const G4AccessPhysicsVector* RIndex = reinterpret_cast<const G4AccessPhysicsVector*>(MPT->GetProperty(kRINDEX));
+	if (!RIndex)
+		RIndex = reinterpret_cast<const G4AccessPhysicsVector*>(MPT->GetProperty(kREALRINDEX));
+	if (!RIndex)
+		return aKey;
+	const std::vector<G4double>& energyVec = RIndex->GetBinVector();
+	const std::vector<G4double>& RIVector = RIndex->GetDataVector();
+	HashBytes(aKey, energyVec.data(), energyVec.size() * sizeof(G4double));
+	HashBytes(aKey, RIVector.data(), RIVector.size() * sizeof(G4double));
+	// exact integration follows the RIndex interpolation, i.e., spline (or not)
+	if (exactIntegration)
+		HashBytes(aKey, RIndex->GetSecDerivative().data(), RIndex->GetSecDerivative().size() * sizeof(G4double));
+	return aKey;
+}
+
+std::vector<std::uint64_t> G4ChRPhysicsTableCache::GetMaterialTableKeys(const unsigned int noOfBetaSteps, const G4double betaGridTolerance,
+	const G4bool exactIntegration, G4ChRExoticFlagFunction anExoticFlagFunction) {
+	std::vector<std::uint64_t> materialKeys(G4Material::GetNumberOfMaterials());
+	for (size_t materialID = 0; materialID < materialKeys.size(); materialID++)
+		materialKeys[materialID] = GetMaterialTableKey(materialID, noOfBetaSteps, betaGridTolerance, exactIntegration, anExoticFlagFunction(materialID));
+	return materialKeys;
+}
+
+G4bool G4ChRPhysicsTableCache::StoreTables(const G4String& fileName, const G4ChRPhysicsTableVector& physDataVec,
+	const unsigned int noOfBetaSteps, const G4double betaGridTolerance, const G4bool exactIntegration, G4ChRExoticFlagFunction anExoticFlagFunction) {
+	std::vector<G4ChRCacheIndexEntry> indexVec(physDataVec.size());
+	std::uint64_t nextOffset = sizeof(m_magic) + 4 * sizeof(std::uint64_t) + indexVec.size() * sizeof(G4ChRCacheIndexEntry);
+	// shared tables are written only once
+	std::unordered_map<const G4ChRPhysTableData*, std::uint64_t> tableToOffset;
+	std::vector<const G4ChRPhysTableData*> tablesToWrite{};
+	for (size_t i = 0; i < physDataVec.size(); i++) {
+		const G4ChRPhysTableData& thePhysData = physDataVec[i];
+		// tables with CDFs might have been forced through UI commands, so the flag is taken from the tables as well
+		G4bool exoticFlag = thePhysData.HasCDFTables() || anExoticFlagFunction(i);
+		auto offsetIter = tableToOffset.emplace(&thePhysData, nextOffset);
+		if (offsetIter.second) {
+			tablesToWrite.push_back(&thePhysData);
+			nextOffset += GetStoredTableSize(thePhysData.GetNoOfBetaNodes(), thePhysData.GetNoOfEnergyNodes());
+		}
+		indexVec[i] = { GetMaterialTableKey(i, noOfBetaSteps, betaGridTolerance, exactIntegration, exoticFlag), thePhysData.GetNoOfBetaNodes(),
+			thePhysData.GetNoOfEnergyNodes(), offsetIter.first->second };
+	}
+	// tables are shared by all particles (and models), so Geant4 asks to store the same tables many times
+	{
+		std::ifstream inStream{ fileName, std::ios::binary };
+		std::vector<G4ChRCacheIndexEntry> storedIndexVec;
+		if (inStream && ReadIndex(inStream, storedIndexVec, noOfBetaSteps) &&
+			std::equal(indexVec.begin(), indexVec.end(), storedIndexVec.begin(), storedIndexVec.end(),
+				[](const G4ChRCacheIndexEntry& value1, const G4ChRCacheIndexEntry& value2) {
+					return value1.m_key == value2.m_key && value1.m_noOfBetaNodes == value2.m_noOfBetaNodes &&
+						value1.m_noOfEnergyNodes == value2.m_noOfEnergyNodes;
+				}))
+			return true;
+	}
+	std::ofstream outStream{ fileName, std::ios::binary | std::ios::trunc };
+	if (!outStream) {
+		std::ostringstream err;
+		err << "Cannot open " << std::quoted(fileName) << " to store Cherenkov physics tables!\n";
+		G4Exception("G4ChRPhysicsTableCache::StoreTables", "WE_ChRTableCache01", JustWarning, err);
+		return false;
+	}
+	const std::uint64_t header[4] = { m_formatVersion, physDataVec.size(), noOfBetaSteps, sizeof(G4ChRTableValue) };
+	outStream.write(m_magic, sizeof(m_magic));
+	outStream.write(reinterpret_cast<const char*>(header), sizeof(header));
+	outStream.write(reinterpret_cast<const char*>(indexVec.data()), indexVec.size() * sizeof(G4ChRCacheIndexEntry));
+	constexpr char padding[8]{};
+	for (const G4ChRPhysTableData* thePhysData : tablesToWrite) {
+		const size_t valueArenaSizeInBytes = thePhysData->GetValueArenaSize() * sizeof(G4ChRTableValue);
+		outStream.write(reinterpret_cast<const char*>(thePhysData->GetAxisArena()), thePhysData->GetAxisArenaSize() * sizeof(G4double));
+		outStream.write(reinterpret_cast<const char*>(thePhysData->GetValueArena()), valueArenaSizeInBytes);
+		// the next axis arena is 8-byte aligned as well
+		outStream.write(padding, (8 - valueArenaSizeInBytes % 8) % 8);
+	}
+	if (!outStream) {
+		std::ostringstream err;
+		err << "Writing Cherenkov physics tables into " << std::quoted(fileName) << " failed!\n";
+		G4Exception("G4ChRPhysicsTableCache::StoreTables", "WE_ChRTableCache02", JustWarning, err);
+		return false;
+	}
+	return true;
+}
+
+G4bool G4ChRPhysicsTableCache::RetrieveTables(const G4String& fileName, G4ChRPhysicsTableVector& physDataVec, const unsigned int noOfBetaSteps,
+	const G4double betaGridTolerance, const G4bool exactIntegration, G4ChRExoticFlagFunction anExoticFlagFunction, G4ChRBuildTableFunction aBuildFunction,
+	size_t& noOfRebuiltTables,
+	G4ChRFinishTableFunction aFinishFunction) {
+	std::ifstream inStream{ fileName, std::ios::binary | std::ios::ate };
+	if (!inStream)
+		return false;
+	const std::uint64_t fileSize = static_cast<std::uint64_t>(inStream.tellg());
+	inStream.seekg(0, std::ios::beg);
+	std::vector<G4ChRCacheIndexEntry> indexVec;
+	if (!ReadIndex(inStream, indexVec, noOfBetaSteps)) {
+		std::ostringstream err;
+		err << "File " << std::quoted(fileName) << " is not a (version " << m_formatVersion << ") Cherenkov physics table file,\n"
+			<< "or it was stored with a different number of beta steps or table precision. Physics tables will be rebuilt!\n";
+		G4Exception("G4ChRPhysicsTableCache::RetrieveTables", "WE_ChRTableCache03", JustWarning, err);
+		return false;
+	}
+	std::unordered_map<std::uint64_t, size_t> keyToIndexEntry;
+	for (size_t i = 0; i < indexVec.size(); i++)
+		keyToIndexEntry.emplace(indexVec[i].m_key, i);
+
+	const std::vector<std::uint64_t> materialKeys = GetMaterialTableKeys(noOfBetaSteps, betaGridTolerance, exactIntegration, anExoticFlagFunction);
+	G4ChRPhysicsTableVector::G4ChRSharedTableMap retrievedTables;
+	for (size_t materialID = 0; materialID < materialKeys.size(); materialID++) {
+		const std::uint64_t aKey = materialKeys[materialID];
+		auto keyIter = keyToIndexEntry.find(aKey);
+		if (keyIter == keyToIndexEntry.end() || retrievedTables.find(aKey) != retrievedTables.end())
+			continue;
+		const G4ChRCacheIndexEntry& anEntry = indexVec[keyIter->second];
+		const std::uint64_t maxNoOfValues = fileSize / sizeof(G4double);
+		if (anEntry.m_noOfBetaNodes > maxNoOfValues || anEntry.m_noOfEnergyNodes > maxNoOfValues ||
+			anEntry.m_offset + GetStoredTableSize(anEntry.m_noOfBetaNodes, anEntry.m_noOfEnergyNodes) > fileSize) {
+			std::ostringstream err;
+			err << "File " << std::quoted(fileName) << " is corrupted. Physics tables will be rebuilt!\n";
+			G4Exception("G4ChRPhysicsTableCache::RetrieveTables", "WE_ChRTableCache04", JustWarning, err);
+			return false;
+		}
+		auto thePhysData = std::make_shared<G4ChRPhysTableData>();
+		thePhysData->AllocateTables(static_cast<size_t>(anEntry.m_noOfBetaNodes), static_cast<size_t>(anEntry.m_noOfEnergyNodes));
+		inStream.seekg(static_cast<std::streamoff>(anEntry.m_offset), std::ios::beg);
+		inStream.read(reinterpret_cast<char*>(thePhysData->GetAxisArenaToFill()), thePhysData->GetAxisArenaSize() * sizeof(G4double));
+		inStream.read(reinterpret_cast<char*>(thePhysData->GetValueArenaToFill()), thePhysData->GetValueArenaSize() * sizeof(G4ChRTableValue));
+		if (!inStream) {
+			std::ostringstream err;
+			err << "Reading Cherenkov physics tables from " << std::quoted(fileName) << " failed. Physics tables will be rebuilt!\n";
+			G4Exception("G4ChRPhysicsTableCache::RetrieveTables", "WE_ChRTableCache05", JustWarning, err);
+			return false;
+		}
+		// the grid lookup is not stored, it's derived from the beta column
+		thePhysData->UpdateBetaGridLookup();
+		if (aFinishFunction)
+			aFinishFunction(materialID, *thePhysData);
+		retrievedTables.emplace(aKey, std::move(thePhysData));
+	}
+	G4ChRPhysicsTableVector newPhysDataVec{};
+	noOfRebuiltTables = newPhysDataVec.BuildTables(materialKeys, aBuildFunction, retrievedTables);
+	physDataVec = std::move(newPhysDataVec);
+	return true;
+}
+
+//=========private G4ChRPhysicsTableCache:: methods=========
+
+G4bool G4ChRPhysicsTableCache::ReadIndex(std::istream& inStream, std::vector<G4ChRCacheIndexEntry>& indexVec, const unsigned int noOfBetaSteps) {
+	char magic[sizeof(m_magic)];
+	std::uint64_t header[4];
+	inStream.read(magic, sizeof(magic));
+	inStream.read(reinterpret_cast<char*>(header), sizeof(header));
+	if (!inStream || std::memcmp(magic, m_magic, sizeof(m_magic)) != 0 || header[0] != m_formatVersion || header[2] != noOfBetaSteps ||
+		header[3] != sizeof(G4ChRTableValue))
+		return false;
+	// reading entry by entry, so a corrupted number of tables cannot allocate a huge vector
+	for (std::uint64_t i = 0; i < header[1]; i++) {
+		G4ChRCacheIndexEntry anEntry;
+		if (!inStream.read(reinterpret_cast<char*>(&anEntry), sizeof(G4ChRCacheIndexEntry)))
+			return false;
+		indexVec.push_back(anEntry);
+	}
+	return true;
+}
+
+std::uint64_t G4ChRPhysicsTableCache::GetStoredTableSize(const std::uint64_t noOfBetaNodes, const std::uint64_t noOfEnergyNodes) {
+	const std::uint64_t valueArenaSizeInBytes = (2 * noOfBetaNodes + noOfEnergyNodes * (noOfBetaNodes + 2)) * sizeof(G4ChRTableValue);
+	return (noOfBetaNodes + noOfEnergyNodes) * sizeof(G4double) + (valueArenaSizeInBytes + 7) / 8 * 8;
+}
\ No newline at end of file
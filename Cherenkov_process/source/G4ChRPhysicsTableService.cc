@@ -0,0 +1,791 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+//G4 headers
+#include "G4ChRPhysicsTableService.hh"
+#include "G4ChRPhysicsTableCache.hh"
+#include "G4AccessPhysicsVectors.hh"
+#include "GlobalFunctions.hh"
+#include "G4Material.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4ExtraOpticalParameters.hh"
+#include "G4Threading.hh"
+//std:: headers
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <unordered_set>
+
+#define pow2(x) ((x) * (x))
+
+//two static helper methods based around this translation unit - definition at the end of the file
+static void PrintSimpleTables(const G4Material*, const G4ChRPhysTableData&);
+static void PrintMoreComplexTables(const unsigned char, const G4Material*, const G4ChRPhysTableData&);
+//helpers for building physics tables - definition at the end of the file
+struct G4ChRAdaptiveBetaNode {
+	G4double m_beta = 0.;
+	G4double m_leftIntegral = 0.;
+	G4double m_rightIntegral = 0.;
+	std::vector<G4double> m_CDFRow{}; // empty if exotic tables are not built
+};
+// integrates ChR for a beta value; optionally fills a normalized CDF row and/or cumulative big-beta columns
+// secDerivative == nullptr -> trapezoidal rule between RIndex nodes, otherwise exact integration (see IntegrateSegmentExactly)
+static void IntegrateBetaNode(const G4double beta, const std::vector<G4double>& energyVec, const std::vector<G4double>& RIVector,
+	const std::vector<G4double>* secDerivative, G4double& deltaE, G4double& ChRIntensity, G4double* aCDFRow,
+	G4double* bigBetaLeftColumn = nullptr, G4double* bigBetaRightColumn = nullptr);
+static std::vector<G4ChRAdaptiveBetaNode> BuildAdaptiveBetaNodes(const G4double betaLowLimit, const G4double betaHighLimit, const G4double tolerance,
+	const std::vector<G4double>& energyVec, const std::vector<G4double>& RIVector, const std::vector<G4double>* secDerivative, const G4bool exoticFlag);
+// RINDEX, or REALRINDEX if RINDEX is not defined (nullptr if neither is)
+static const G4AccessPhysicsVector* GetRIndexOfMaterial(const size_t materialID);
+
+std::shared_ptr<const G4ChRPhysicsTableVector> G4ChRPhysicsTableService::m_ChRPhysDataVec = std::make_shared<const G4ChRPhysicsTableVector>();
+// snapshots start from generation 0, so they take the published tables on their first update
+std::atomic<std::uint64_t> G4ChRPhysicsTableService::m_tablesGeneration{ 1 };
+unsigned int G4ChRPhysicsTableService::m_noOfBetaSteps = 20;
+G4double G4ChRPhysicsTableService::m_betaGridTolerance = 0.;
+G4bool G4ChRPhysicsTableService::m_useRejectionSampling = false;
+G4bool G4ChRPhysicsTableService::m_useExactIntegration = false;
+unsigned int G4ChRPhysicsTableService::m_noOfRIndexGridNodes = 0;
+// the adaptive grid starts from a few uniform intervals that are bisected at most o_maxAdaptiveBetaDepth times
+static constexpr unsigned int o_initialNoOfAdaptiveBetaSteps = 4;
+static constexpr unsigned int o_maxAdaptiveBetaDepth = 12;
+// exact integration of spline segments - roots of beta * n(E) = 1 are searched in o_noOfSplinePieces pieces of a segment
+static constexpr unsigned int o_noOfSplinePieces = 8;
+static constexpr unsigned int o_noOfRootBisections = 60;
+// the file name doesn't depend on the process that stores the tables, so G4OpticalPhysics_option1 and _option2 share it
+static constexpr const char* o_cacheOwnerName = "G4ChRPhysicsTableService";
+
+//=========public G4ChRPhysicsTableService:: methods=========
+
+G4bool G4ChRPhysicsTableService::BuildPhysicsTables(const unsigned char verboseLevel) {
+	// workers only read the tables published by the master
+	if (G4Threading::IsWorkerThread())
+		return false;
+	const std::shared_ptr<const G4ChRPhysicsTableVector> oldPhysDataVec = GetChRPhysDataVec();
+	// the keys are fingerprints of the tables (RINDEX, exotic flag and beta-grid parameters)
+	const std::vector<std::uint64_t> materialKeys =
+		G4ChRPhysicsTableCache::GetMaterialTableKeys(m_noOfBetaSteps, m_betaGridTolerance, m_useExactIntegration, &GetCDFTablesFlag);
+	if (materialKeys == oldPhysDataVec->GetMaterialKeys())
+		return false;
+	//only tables of added or changed materials are built, others are taken from the current tables
+	//materials are independent, so tables are built concurrently (once for materials with the same RINDEX) and published at once
+	G4ChRPhysicsTableVector newPhysDataVec{};
+	const size_t noOfBuiltTables = newPhysDataVec.BuildTables(materialKeys, &BuildPhysicsTableData, oldPhysDataVec->GetSharedTables());
+	const size_t noOfUniqueTables = newPhysDataVec.GetNoOfUniqueTables();
+	PublishChRPhysDataVec(std::move(newPhysDataVec));
+	if (verboseLevel > 0) {
+		std::cout << "Cherenkov physics tables updated (" << noOfBuiltTables << " of " << noOfUniqueTables
+			<< " unique tables had to be built)\n";
+		PrintChRPhysDataVec();
+	}
+	return true;
+}
+
+G4bool G4ChRPhysicsTableService::StorePhysicsTables(const G4String& directory) {
+	const std::shared_ptr<const G4ChRPhysicsTableVector> physDataVec = GetChRPhysDataVec();
+	if (physDataVec->size() != G4Material::GetNumberOfMaterials())
+		return false;
+	return G4ChRPhysicsTableCache::StoreTables(G4ChRPhysicsTableCache::GetCacheFileName(directory, o_cacheOwnerName),
+		*physDataVec, m_noOfBetaSteps, m_betaGridTolerance, m_useExactIntegration, &GetCDFTablesFlag);
+}
+
+G4bool G4ChRPhysicsTableService::RetrievePhysicsTables(const G4String& directory, const unsigned char verboseLevel) {
+	// tables are shared by all processes, models and particles, so the file is read only once; later, only
+	// tables of added or changed materials are built
+	if (G4Threading::IsWorkerThread())
+		return false;
+	if (!GetChRPhysDataVec()->empty()) {
+		BuildPhysicsTables(verboseLevel);
+		return true;
+	}
+	const G4String fileName = G4ChRPhysicsTableCache::GetCacheFileName(directory, o_cacheOwnerName);
+	size_t noOfRebuiltTables = 0;
+	G4ChRPhysicsTableVector newPhysDataVec{};
+	if (!G4ChRPhysicsTableCache::RetrieveTables(fileName, newPhysDataVec, m_noOfBetaSteps, m_betaGridTolerance, m_useExactIntegration,
+		&GetCDFTablesFlag, &BuildPhysicsTableData, noOfRebuiltTables, [](const size_t materialID, G4ChRPhysTableData& thePhysData) {
+			// alias tables and RIndex grids are not stored
+			if (thePhysData.HasCDFTables())
+				thePhysData.BuildAliasTables();
+			if (const G4MaterialPropertiesTable* MPT = (*G4Material::GetMaterialTable())[materialID]->GetMaterialPropertiesTable()) {
+				const G4PhysicsVector* RIndex = MPT->GetProperty(kRINDEX);
+				BuildUniformRIndexGrid(RIndex ? RIndex : MPT->GetProperty(kREALRINDEX), thePhysData);
+			}
+		}))
+		return false;
+	const size_t noOfUniqueTables = newPhysDataVec.GetNoOfUniqueTables();
+	PublishChRPhysDataVec(std::move(newPhysDataVec));
+	if (verboseLevel > 0) {
+		std::cout << "Cherenkov physics tables retrieved from " << std::quoted(fileName) << " ("
+			<< noOfRebuiltTables << " of " << noOfUniqueTables << " unique tables had to be rebuilt)\n";
+		PrintChRPhysDataVec();
+	}
+	return true;
+}
+
+G4bool G4ChRPhysicsTableService::AddExoticRIndexPhysicsTable(const size_t materialID, G4bool forceExoticFlag) {
+	if (G4Threading::IsWorkerThread())
+		return false;
+	G4ChRPhysTableData thePhysVecData{};
+	G4bool builtTables = BuildPhysicsTableData(materialID, forceExoticFlag, thePhysVecData);
+	// the table might be shared with other materials, so it's replaced only for this one
+	const G4bool exoticFlag = forceExoticFlag || GetCDFTablesFlag(materialID);
+	// copy (of pointers to tables), update, publish
+	G4ChRPhysicsTableVector newPhysDataVec = *GetChRPhysDataVec();
+	newPhysDataVec.SetTable(materialID,
+		G4ChRPhysicsTableCache::GetMaterialTableKey(materialID, m_noOfBetaSteps, m_betaGridTolerance, m_useExactIntegration, exoticFlag), std::move(thePhysVecData));
+	PublishChRPhysDataVec(std::move(newPhysDataVec));
+	return builtTables;
+}
+
+void G4ChRPhysicsTableService::RemoveExoticRIndexPhysicsTable(const size_t materialID) {
+	// CDF tables are used by non-exotic materials as well
+	if (!m_useRejectionSampling || G4Threading::IsWorkerThread())
+		return;
+	try {
+		// error conditions should never happen... anyway, we are in G4State_Idle, so a few processor cycles won't hurt
+		G4ChRPhysicsTableVector newPhysDataVec = *GetChRPhysDataVec();
+		const G4ChRPhysTableData& theSharedData = newPhysDataVec.at(materialID);
+
+		if (!theSharedData.HasCDFTables()) {
+			std::string err{ "No ChR exotic physics table data found while the m_exoticRIndex flag is 'true'!\n" };
+			err += "This is a problem in the logic of the code, please report the issue!\n";
+			throw err;
+		}
+		// the table might be shared with other materials, so this material gets its own copy without CDF tables
+		newPhysDataVec.SetTable(materialID,
+			G4ChRPhysicsTableCache::GetMaterialTableKey(materialID, m_noOfBetaSteps, m_betaGridTolerance, m_useExactIntegration, false), theSharedData.CopyWithoutCDFTables());
+		PublishChRPhysDataVec(std::move(newPhysDataVec));
+	}
+	catch (std::out_of_range) {
+		std::ostringstream err;
+		err << "The material with index " << materialID << " is not found in the built physics tables!\n";
+		G4Exception("G4ChRPhysicsTableService::RemoveExoticRIndexPhysicsTable", "FE_ChRTableService01", FatalException, err);
+	}
+	catch (const std::string err) {
+		G4Exception("G4ChRPhysicsTableService::RemoveExoticRIndexPhysicsTable", "FE_ChRTableService02", FatalException, err.c_str());
+	}
+}
+
+//the following method has the same idea as the original G4Cerenkov... still, the original method
+//limited the usability of G4Cerenkov, so physics tables are built through betaValues now
+G4double G4ChRPhysicsTableService::CalculateAverageNumberOfPhotons(const G4double aCharge, const G4double betaValue, const G4ChRPhysTableData& physData) {
+	constexpr G4double Rfact = 369.81 / (eV * cm);
+	if (betaValue <= 0)
+		return 0.;
+	// the following condition should never happen - it was already done in the StepLength method
+	/*if (physData.GetNoOfBetaNodes() <= 1)
+		return 0.;*/
+	G4double deltaE, ChRRightIntPart;
+	if (betaValue <= physData.GetFrontBeta()) {
+		deltaE = 0.;
+		ChRRightIntPart = 0.;
+	}
+	else if (betaValue >= physData.GetBackBeta()) {
+		const size_t lastNode = physData.GetNoOfBetaNodes() - 1;
+		deltaE = physData.GetLeftIntegral(lastNode);
+		ChRRightIntPart = physData.GetRightIntegral(lastNode);
+	}
+	else {
+		size_t lowLoc = physData.FindUpperBetaNode(betaValue);
+		deltaE = G4LinearInterpolate2D_GetY(physData.GetLeftIntegral(lowLoc), physData.GetLeftIntegral(lowLoc - 1),
+			physData.GetBetaValue(lowLoc), physData.GetBetaValue(lowLoc - 1), betaValue);
+		ChRRightIntPart = G4LinearInterpolate2D_GetY(physData.GetRightIntegral(lowLoc), physData.GetRightIntegral(lowLoc - 1),
+			physData.GetBetaValue(lowLoc), physData.GetBetaValue(lowLoc - 1), betaValue);
+	}
+	return Rfact * pow2(aCharge) / pow2(eplus) * (deltaE - ChRRightIntPart / pow2(betaValue));
+}
+
+G4double G4ChRPhysicsTableService::GetThresholdEnergy(const G4PhysicsFreeVector* RIndex, const G4double beta) {
+	const G4AccessPhysicsVector* accessRIndex = reinterpret_cast<const G4AccessPhysicsVector*>(RIndex);
+	const std::vector<G4double>& energyVec = accessRIndex->GetBinVector();
+	const std::vector<G4double>& RIVector = accessRIndex->GetDataVector();
+	// ChR condition: beta * RIndex > 1
+	const G4double thresholdRIndex = 1. / beta;
+	size_t upperLoc = static_cast<size_t>(std::lower_bound(RIVector.begin(), RIVector.end(), thresholdRIndex) - RIVector.begin());
+	if (upperLoc == 0)
+		return energyVec.front();
+	if (upperLoc == RIVector.size())
+		return energyVec.back();
+	return G4LinearInterpolate2D_GetX(RIVector[upperLoc - 1], RIVector[upperLoc], energyVec[upperLoc - 1], energyVec[upperLoc], thresholdRIndex);
+}
+
+void G4ChRPhysicsTableService::PrintChRPhysDataVec(const unsigned char printLevel, const G4Material* aMaterial) {
+	const std::shared_ptr<const G4ChRPhysicsTableVector> physDataVec = GetChRPhysDataVec();
+	const G4MaterialTable* theMaterialTable = G4Material::GetMaterialTable();
+	std::cout.fill('=');
+	std::cout << std::setw(66) << '\n';
+	if (aMaterial)
+		std::cout << "Begin of PrintChRPhysDataVec( " << std::to_string(printLevel) << ", " << aMaterial->GetName() << " )\n\n";
+	else
+		std::cout << "Begin of PrintChRPhysDataVec( " << std::to_string(printLevel) << ", nullptr )\n\n";
+
+	std::cout << "Number of emitted Cherenkov photons can be calculated as:\nconst * (leftIntegral - rightIntegral / beta^2)\n";
+	if (aMaterial) { //if a specific material is selected, the method prints only about that method
+		if (printLevel == 0) {
+			PrintSimpleTables(aMaterial, (*physDataVec)[aMaterial->GetIndex()]);
+			goto ExitPrintFunction;
+		}
+		PrintMoreComplexTables(printLevel, aMaterial, (*physDataVec)[aMaterial->GetIndex()]);
+		goto ExitPrintFunction;
+	}
+	std::cout << "\nBuilt Cherenkov physics tables (" << physDataVec->GetNoOfUniqueTables() << " unique tables for "
+		<< physDataVec->size() << " materials) are:\n\n";
+	if (printLevel == 0) {
+		for (size_t i = 0; i < physDataVec->size(); i++)
+			PrintSimpleTables((*theMaterialTable)[i], (*physDataVec)[i]);
+		goto ExitPrintFunction;
+	}
+	std::cout << std::setfill('+') << std::setw(66) << '\n';
+	for (size_t i = 0; i < physDataVec->size(); i++) {
+		PrintMoreComplexTables(printLevel, (*theMaterialTable)[i], (*physDataVec)[i]);
+		std::cout << '\n' << std::setfill('+') << std::setw(66) << '\n';
+	}
+ExitPrintFunction:
+	if (aMaterial)
+		std::cout << "\nEnd of PrintChRPhysDataVec( " << std::to_string(printLevel) << ", " << aMaterial->GetName() << " )\n";
+	else
+		std::cout << "\nEnd of PrintChRPhysDataVec( " << std::to_string(printLevel) << ", nullptr )\n";
+	std::cout << std::setfill('=') << std::setw(66) << '\n';
+}
+
+void G4ChRPhysicsTableService::ValidatePhysicsTables() {
+	const std::shared_ptr<const G4ChRPhysicsTableVector> physDataVec = GetChRPhysDataVec();
+	const G4MaterialTable* theMaterialTable = G4Material::GetMaterialTable();
+	std::cout << std::setfill('=') << std::setw(66) << '\n'
+		<< "Validation of Cherenkov physics tables (values stored as " << (sizeof(G4ChRTableValue) == sizeof(float) ? "float" : "double")
+		<< ")\nagainst the double-precision integration at all beta nodes:\n"
+		<< "yield - max. |yield - reference| / (reference yield at betaMax)\n"
+		<< "CDF - max. |CDF - reference| of all CDF rows, i.e., the max. distance of spectra\n"
+		<< "bigBeta - max. |value - reference| / (column total) of the big-beta columns\n"
+		<< std::setfill(' ');
+	std::unordered_set<const G4ChRPhysTableData*> validatedTables;
+	size_t tablesSizeInBytes = 0, doubleTablesSizeInBytes = 0;
+	G4double maxYieldError = 0., maxCDFError = 0.;
+	for (size_t materialID = 0; materialID < physDataVec->size(); materialID++) {
+		const G4ChRPhysTableData& theData = (*physDataVec)[materialID];
+		// shared tables are validated only once; tables of constant RIndex have nothing to interpolate
+		if (theData.GetNoOfBetaNodes() < 2 || !(theData.GetBackBeta() > theData.GetFrontBeta()) || !validatedTables.insert(&theData).second)
+			continue;
+		const G4AccessPhysicsVector* RIndex = GetRIndexOfMaterial(materialID);
+		if (!RIndex)
+			continue;
+		const std::vector<G4double>& energyVec = RIndex->GetBinVector();
+		const std::vector<G4double>& RIVector = RIndex->GetDataVector();
+		const std::vector<G4double>* secDerivative = m_useExactIntegration ? &RIndex->GetSecDerivative() : nullptr;
+		const size_t noOfEnergyNodes = theData.GetNoOfEnergyNodes();
+		std::vector<G4double> CDFRow(energyVec.size()), bigBetaLeftColumn(energyVec.size()), bigBetaRightColumn(energyVec.size());
+		G4double deltaE, ChRIntensity;
+		IntegrateBetaNode(theData.GetBackBeta(), energyVec, RIVector, secDerivative, deltaE, ChRIntensity, nullptr,
+			bigBetaLeftColumn.data(), bigBetaRightColumn.data());
+		const G4double yieldScale = deltaE - ChRIntensity / pow2(theData.GetBackBeta());
+		G4double yieldError = 0., CDFError = 0., bigBetaError = 0.;
+		for (size_t j = 0; j < theData.GetNoOfBetaNodes(); j++) {
+			const G4double beta = theData.GetBetaValue(j);
+			IntegrateBetaNode(beta, energyVec, RIVector, secDerivative, deltaE, ChRIntensity, noOfEnergyNodes ? CDFRow.data() : nullptr);
+			const G4double yieldDifference = (theData.GetLeftIntegral(j) - theData.GetRightIntegral(j) / pow2(beta)) - (deltaE - ChRIntensity / pow2(beta));
+			yieldError = std::max(yieldError, std::abs(yieldDifference) / yieldScale);
+			for (size_t k = 0; k < noOfEnergyNodes; k++)
+				CDFError = std::max(CDFError, std::abs(theData.GetCDFRow(j)[k] - CDFRow[k]));
+		}
+		for (size_t k = 0; k < noOfEnergyNodes; k++) {
+			bigBetaError = std::max(bigBetaError, std::abs(theData.GetBigBetaLeftColumn()[k] - bigBetaLeftColumn[k]) / bigBetaLeftColumn.back());
+			bigBetaError = std::max(bigBetaError, std::abs(theData.GetBigBetaRightColumn()[k] - bigBetaRightColumn[k]) / bigBetaRightColumn.back());
+		}
+		maxYieldError = std::max(maxYieldError, yieldError);
+		maxCDFError = std::max(maxCDFError, CDFError);
+		const size_t tableSizeInBytes = theData.GetAxisArenaSize() * sizeof(G4double) + theData.GetValueArenaSize() * sizeof(G4ChRTableValue);
+		tablesSizeInBytes += tableSizeInBytes;
+		doubleTablesSizeInBytes += (theData.GetAxisArenaSize() + theData.GetValueArenaSize()) * sizeof(G4double);
+		std::cout << std::setw(20) << std::left << (*theMaterialTable)[materialID]->GetName() << std::right << std::scientific << std::setprecision(3)
+			<< " | yield: " << yieldError;
+		if (noOfEnergyNodes)
+			std::cout << " | CDF: " << CDFError << " | bigBeta: " << bigBetaError;
+		else // spectra of non-exotic materials are sampled from RIndex directly (see m_useRejectionSampling)
+			std::cout << " | CDF: " << std::setw(9) << '-' << " | bigBeta: " << std::setw(9) << '-';
+		std::cout << std::defaultfloat << " | " << tableSizeInBytes << " B\n";
+	}
+	std::cout << "Max. yield error: " << std::scientific << std::setprecision(3) << maxYieldError << ", max. CDF error: " << maxCDFError
+		<< std::defaultfloat << "\nArenas of " << validatedTables.size() << " validated tables take " << tablesSizeInBytes << " B ("
+		<< doubleTablesSizeInBytes << " B with double values)\n"
+		<< std::setfill('=') << std::setw(66) << '\n';
+}
+
+G4ChRInterpolationErrors G4ChRPhysicsTableService::EstimateInterpolationErrors(const size_t materialID) {
+	G4ChRInterpolationErrors theErrors{};
+	const std::shared_ptr<const G4ChRPhysicsTableVector> physDataVec = GetChRPhysDataVec();
+	if (materialID >= physDataVec->size())
+		return theErrors;
+	const G4ChRPhysTableData& theData = (*physDataVec)[materialID];
+	const G4AccessPhysicsVector* RIndex = GetRIndexOfMaterial(materialID);
+	if (!RIndex || theData.GetNoOfBetaNodes() < 2 || !(theData.GetBackBeta() > theData.GetFrontBeta()))
+		return theErrors;
+	const std::vector<G4double>& energyVec = RIndex->GetBinVector();
+	const std::vector<G4double>& RIVector = RIndex->GetDataVector();
+	const std::vector<G4double>* secDerivative = m_useExactIntegration ? &RIndex->GetSecDerivative() : nullptr;
+	const size_t noOfEnergyNodes = theData.GetNoOfEnergyNodes();
+	const G4double yieldScale = theData.GetLeftIntegral(theData.GetNoOfBetaNodes() - 1) -
+		theData.GetRightIntegral(theData.GetNoOfBetaNodes() - 1) / pow2(theData.GetBackBeta());
+	std::vector<G4double> CDFRow(energyVec.size());
+	for (size_t j = 1; j < theData.GetNoOfBetaNodes(); j++) {
+		const G4double beta = 0.5 * (theData.GetBetaValue(j - 1) + theData.GetBetaValue(j));
+		G4double deltaE, ChRIntensity;
+		IntegrateBetaNode(beta, energyVec, RIVector, secDerivative, deltaE, ChRIntensity, noOfEnergyNodes ? CDFRow.data() : nullptr);
+		// the middle of the interval, so the linear interpolation is the average of the nodes
+		const G4double leftIntegral = 0.5 * (theData.GetLeftIntegral(j - 1) + theData.GetLeftIntegral(j));
+		const G4double rightIntegral = 0.5 * (theData.GetRightIntegral(j - 1) + theData.GetRightIntegral(j));
+		const G4double yieldDifference = (leftIntegral - rightIntegral / pow2(beta)) - (deltaE - ChRIntensity / pow2(beta));
+		theErrors.m_yieldError = std::max(theErrors.m_yieldError, std::abs(yieldDifference) / yieldScale);
+		for (size_t k = 0; k < noOfEnergyNodes; k++)
+			theErrors.m_CDFError = std::max(theErrors.m_CDFError, std::abs(theData.GetCDFRow(j)[k] - CDFRow[k]));
+	}
+	return theErrors;
+}
+
+//=========private G4ChRPhysicsTableService:: methods=========
+
+G4bool G4ChRPhysicsTableService::GetExoticRIndexFlag(const size_t materialID) {
+	const G4Material* aMaterial = (*G4Material::GetMaterialTable())[materialID];
+	const G4MaterialPropertiesTable* MPT = aMaterial->GetMaterialPropertiesTable();
+	if (!MPT)
+		return false;
+	const G4AccessPhysicsVector* RIndex = reinterpret_cast<const G4AccessPhysicsVector*>(MPT->GetProperty(kRINDEX));
+	if (!RIndex)
+		RIndex = reinterpret_cast<const G4AccessPhysicsVector*>(MPT->GetProperty(kREALRINDEX));
+	if (!RIndex)
+		return false;
+	// used for logical volumes that are not registered in G4ExtraOpticalParameters (e.g., with G4StandardCherenkovProcess)
+	const G4bool initialExoticFlag = !std::is_sorted(RIndex->GetDataVector().begin(), RIndex->GetDataVector().end());
+	G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+	const auto& ChRMatDataMap = G4ExtraOpticalParameters::GetInstance()->GetChRMatData();
+	for (const auto* i : *lvStore) {
+		// comparing material memory addresses
+		if (i->GetMaterial() != aMaterial)
+			continue;
+		auto matDataIter = ChRMatDataMap.find(i);
+		if (matDataIter != ChRMatDataMap.end() ? matDataIter->second.GetExoticRIndex() : initialExoticFlag)
+			return true;
+	}
+	return false;
+}
+
+void G4ChRPhysicsTableService::PublishChRPhysDataVec(G4ChRPhysicsTableVector&& newPhysDataVec) {
+	if (G4Threading::IsWorkerThread())
+		return;
+	std::atomic_store_explicit(&m_ChRPhysDataVec, std::make_shared<const G4ChRPhysicsTableVector>(std::move(newPhysDataVec)), std::memory_order_release);
+	m_tablesGeneration.fetch_add(1, std::memory_order_acq_rel);
+}
+
+G4bool G4ChRPhysicsTableService::GetCDFTablesFlag(const size_t materialID) {
+	return !m_useRejectionSampling || GetExoticRIndexFlag(materialID);
+}
+
+G4bool G4ChRPhysicsTableService::BuildPhysicsTableData(const size_t materialID, G4bool forceExoticFlag, G4ChRPhysTableData& thePhysVecData) {
+	const G4MaterialTable* theMaterialTable = G4Material::GetMaterialTable();
+	G4MaterialPropertiesTable* MPT = (*theMaterialTable)[materialID]->GetMaterialPropertiesTable();
+	if (!MPT)
+		return false;
+	G4AccessPhysicsVector* RIndex = reinterpret_cast<G4AccessPhysicsVector*>(MPT->GetProperty(kRINDEX));
+	if (!RIndex) //NOTE: I'm not sure if those are left separate on purpose!
+		RIndex = reinterpret_cast<G4AccessPhysicsVector*>(MPT->GetProperty(kREALRINDEX));
+	if (!RIndex)
+		return false;
+	const std::vector<G4double>& RIVector = RIndex->GetDataVector();
+	G4double nMax = RIndex->GetRealDataVectorMax();
+	G4double nMin = RIndex->GetRealDataVectorMin();
+	if (nMax <= 1.)
+		return false;
+	const std::vector<G4double>& energyVec = RIndex->GetBinVector();
+	G4double betaLowLimit = 1 / nMax;
+	G4double betaHighLimit = 1 / nMin;
+	// for the following, the radiation can either be produced, or not
+	if (nMax == nMin) {
+		G4double deltaE = energyVec.back() - energyVec.front();
+		G4double ChRIntensity = deltaE / nMax;
+		thePhysVecData.AllocateTables(2);
+		thePhysVecData.SetBetaNode(0, betaLowLimit, deltaE, ChRIntensity);
+		thePhysVecData.SetBetaNode(1, betaLowLimit, deltaE, ChRIntensity);
+		return false;
+	}
+	if (!forceExoticFlag)
+		forceExoticFlag = GetCDFTablesFlag(materialID);
+	const size_t noOfEnergyNodes = forceExoticFlag ? energyVec.size() : 0;
+	const std::vector<G4double>* secDerivative = m_useExactIntegration ? &RIndex->GetSecDerivative() : nullptr;
+	if (m_betaGridTolerance > 0.) {
+		const std::vector<G4ChRAdaptiveBetaNode> betaNodes =
+			BuildAdaptiveBetaNodes(betaLowLimit, betaHighLimit, m_betaGridTolerance, energyVec, RIVector, secDerivative, forceExoticFlag);
+		thePhysVecData.AllocateTables(betaNodes.size(), noOfEnergyNodes);
+		for (size_t j = 0; j < betaNodes.size(); j++) {
+			thePhysVecData.SetBetaNode(j, betaNodes[j].m_beta, betaNodes[j].m_leftIntegral, betaNodes[j].m_rightIntegral);
+			if (forceExoticFlag)
+				std::copy(betaNodes[j].m_CDFRow.begin(), betaNodes[j].m_CDFRow.end(), thePhysVecData.GetCDFRowToFill(j));
+		}
+	}
+	else {
+		G4double deltaBeta = (betaHighLimit - betaLowLimit) / m_noOfBetaSteps;
+		thePhysVecData.AllocateTables((size_t)m_noOfBetaSteps + 1, noOfEnergyNodes);
+		// CDF rows are integrated (and normalized) in double, and then stored as G4ChRTableValue
+		std::vector<G4double> CDFRow(noOfEnergyNodes);
+		for (size_t j = 0; j <= m_noOfBetaSteps; j++) {
+			G4double deltaE, ChRIntensity;
+			G4double beta = betaLowLimit + (G4double)j * deltaBeta;
+			IntegrateBetaNode(beta, energyVec, RIVector, secDerivative, deltaE, ChRIntensity, forceExoticFlag ? CDFRow.data() : nullptr);
+			thePhysVecData.SetBetaNode(j, beta, deltaE, ChRIntensity);
+			if (forceExoticFlag)
+				std::copy(CDFRow.begin(), CDFRow.end(), thePhysVecData.GetCDFRowToFill(j));
+		}
+	}
+	if (forceExoticFlag) {
+		std::copy(energyVec.begin(), energyVec.end(), thePhysVecData.GetEnergyColumnToFill());
+		G4double deltaE, ChRIntensity;
+		std::vector<G4double> bigBetaLeftColumn(noOfEnergyNodes), bigBetaRightColumn(noOfEnergyNodes);
+		IntegrateBetaNode(thePhysVecData.GetBackBeta(), energyVec, RIVector, secDerivative, deltaE, ChRIntensity, nullptr,
+			bigBetaLeftColumn.data(), bigBetaRightColumn.data());
+		std::copy(bigBetaLeftColumn.begin(), bigBetaLeftColumn.end(), thePhysVecData.GetBigBetaLeftColumnToFill());
+		std::copy(bigBetaRightColumn.begin(), bigBetaRightColumn.end(), thePhysVecData.GetBigBetaRightColumnToFill());
+		thePhysVecData.BuildAliasTables();
+	}
+	thePhysVecData.UpdateBetaGridLookup();
+	BuildUniformRIndexGrid(RIndex, thePhysVecData);
+	return true;
+}
+
+void G4ChRPhysicsTableService::BuildUniformRIndexGrid(const G4PhysicsVector* RIndex, G4ChRPhysTableData& thePhysVecData) {
+	// tables of constant RIndex don't sample photon energies from RIndex
+	if (m_noOfRIndexGridNodes < 2 || !RIndex || !(thePhysVecData.GetBackBeta() > thePhysVecData.GetFrontBeta()))
+		return;
+	const G4double minEnergy = RIndex->Energy(0);
+	const G4double maxEnergy = RIndex->GetMaxEnergy();
+	const G4double deltaE = (maxEnergy - minEnergy) / (m_noOfRIndexGridNodes - 1);
+	std::vector<G4double> RIndexValues(m_noOfRIndexGridNodes);
+	for (size_t i = 0; i < RIndexValues.size(); i++)
+		RIndexValues[i] = RIndex->Value(minEnergy + (G4double)i * deltaE);
+	thePhysVecData.SetUniformRIndexGrid(minEnergy, maxEnergy, std::move(RIndexValues));
+	// the largest errors are at RIndex nodes (kinks of RIndex) or in the middle of grid intervals
+	G4double maxError = 0.;
+	for (size_t i = 0; i < RIndex->GetVectorLength(); i++) {
+		const G4double energy = RIndex->Energy(i);
+		maxError = std::max(maxError, std::abs(thePhysVecData.GetRIndexValue(energy) - RIndex->Value(energy)));
+	}
+	for (size_t i = 0; i + 1 < m_noOfRIndexGridNodes; i++) {
+		const G4double energy = minEnergy + ((G4double)i + 0.5) * deltaE;
+		maxError = std::max(maxError, std::abs(thePhysVecData.GetRIndexValue(energy) - RIndex->Value(energy)));
+	}
+	thePhysVecData.SetRIndexGridError(maxError);
+}
+
+//=========static methods of translation unit=========
+
+static void PrintSimpleTables(const G4Material* aMaterial, const G4ChRPhysTableData& theCurrentData) {
+	const size_t tableSize = theCurrentData.GetNoOfBetaNodes();
+	std::cout << std::right << std::setfill('_') << std::setw(52) << '\n'
+		<< "| Material: " << std::setfill(' ') << std::setw(40) << "|\n"
+		<< "| " << std::setw(48) << std::left << aMaterial->GetName() << "|\n"
+		<< '|' << std::right << std::setfill('_') << std::setw(51) << "|\n";
+	if (tableSize <= 1) {
+		std::cout << "| No physics table has been built for this" << std::setfill(' ') << std::setw(10) << "|\n"
+			<< "| material (n = 1 or no n(E))" << std::setw(23) << "|\n"
+			<< '|' << std::right << std::setfill('_') << std::setw(51) << "|\n";
+		return;
+	}
+	std::cout << "|  Beta  | Left ChR integral | Right ChR integral |\n"
+		<< '|' << std::setw(9) << '|' << std::setw(20) << '|' << std::setw(22) << "|\n";
+	std::cout.fill(' ');
+	for (size_t i = 0; i < tableSize; i++) {
+		std::cout << '|' << std::setprecision(4) << std::fixed << std::setw(7) << theCurrentData.GetBetaValue(i) << " |"
+			<< std::scientific << std::setw(15) << theCurrentData.GetLeftIntegral(i) << std::setw(5) << '|'
+			<< std::setw(15) << theCurrentData.GetRightIntegral(i) << std::setw(7) << "|\n";
+	}
+	std::cout << '|' << std::setfill('_') << std::setw(9) << '|' << std::setw(20) << '|' << std::setw(22) << "|\n";
+	std::cout.fill(' ');
+	if (theCurrentData.HasUniformRIndexGrid())
+		std::cout << "RIndex resampled onto " << theCurrentData.GetNoOfRIndexGridNodes() << " uniform energy nodes (max. RIndex error: "
+		<< std::scientific << std::setprecision(3) << theCurrentData.GetRIndexGridError() << std::defaultfloat << ")\n";
+}
+
+static void PrintMoreComplexTables(const unsigned char printLevel, const G4Material* aMaterial, const G4ChRPhysTableData& theCurrentData) {
+	const size_t tableSize = theCurrentData.GetNoOfBetaNodes();
+	if (tableSize <= 1) {
+		std::cout << "No Cherenkov physics tables were found for material "
+			<< std::quoted(aMaterial->GetName()) << "\nThat means the refractive index of the material is '1', or it is not defined!\n";
+		return;
+	}
+	if (!theCurrentData.HasCDFTables()) {
+		std::cout << "Material " << std::quoted(aMaterial->GetName()) << " has only standard Cherenkov\n"
+			<< "physics tables built (no CDF tables were found):\n";
+		PrintSimpleTables(aMaterial, theCurrentData);
+		return;
+	}
+	std::cout << "Material: " << std::quoted(aMaterial->GetName())
+		<< "\nCherenkov CDF tables found!\n"
+		<< "Standard physics tables are:\n";
+	PrintSimpleTables(aMaterial, theCurrentData);
+	std::cout << "\nCDF tables between betaMin and betaMax are:\n";
+	size_t noOfColumns = 8; // going with 8 max possible no of columns per table
+	size_t remainder = tableSize % noOfColumns; // no of elements not in tables
+	size_t noOfTables = tableSize / noOfColumns; // no of table parts
+	if (remainder != 0) // if I can't place all elements in tables, no of tables ++
+		noOfTables++;
+	noOfColumns = tableSize / noOfTables; // normal number of columns per tables
+	remainder = tableSize % noOfColumns; // no of tables with an extra column
+	size_t nextBeginID = 0;
+	size_t noOfRIndexValues = theCurrentData.GetNoOfEnergyNodes();
+	const G4double* energyColumn = theCurrentData.GetEnergyColumn();
+	std::cout.fill('_');
+	for (size_t i = 0; i < noOfTables; i++) {
+		size_t progressiveID;
+		size_t nextEnd = noOfColumns;
+		if (remainder != 0) {
+			remainder--;
+			nextEnd++;
+		}
+		//following setw(NUMBER), where NUMBER = nextEnd * " | x.xxxx" + "| x.xxx" + " |\n" = nextEnd * 9 + 10
+		std::cout << std::setw(nextEnd * 9 + 10) << '\n';
+		std::cout.fill(' ');
+		std::cout << "|  ChR  |" << std::right
+			<< std::setw((nextEnd * 9 + 1) / 2 - 2) << "beta" << std::setw(nextEnd * 9 - ((nextEnd * 9 + 1) / 2 - 3)) << "|\n";
+		std::cout << "| photon|" << std::setfill('-') << std::setw(nextEnd * 9 + 1) << "|\n";
+		std::cout << "| E [eV]|";
+		progressiveID = nextBeginID;
+		std::cout.precision(4);
+		for (; progressiveID != nextBeginID + nextEnd; progressiveID++)
+			std::cout << ' ' << std::fixed << theCurrentData.GetBetaValue(progressiveID) << " |";
+		std::cout << "\n|" << std::setfill('_') << std::setw(8) << '|';
+		for (size_t k = 0; k < nextEnd; k++)
+			std::cout << std::setw(9) << '|';
+		std::cout << '\n';
+		for (size_t j = 0; j < noOfRIndexValues; j++) {
+			progressiveID = nextBeginID;
+			std::cout << "| " << std::setprecision(3) << energyColumn[j] / eV;
+			std::cout.precision(4);
+			for (; progressiveID != nextBeginID + nextEnd; progressiveID++)
+				std::cout << " | " << theCurrentData.GetCDFRow(progressiveID)[j];
+			std::cout << " |\n";
+		}
+		nextBeginID = progressiveID;
+		std::cout << '|' << std::setw(8) << "|";
+		for (size_t k = 0; k < nextEnd; k++)
+			std::cout << std::setw(9) << '|';
+		std::cout << std::endl;
+	}
+	if (printLevel < 2)
+		return;
+	std::cout << "\nCDF for higher than betaMax is calculated based on the following values:\n";
+	std::cout << std::setfill('_') << std::setw(52) << '\n';
+	std::cout << "| E [eV] | Left ChR integral | Right ChR integral |\n"
+		<< '|' << std::setw(9) << '|' << std::setw(20) << '|' << std::setw(22) << "|\n";
+	std::cout.fill(' ');
+	const G4ChRTableValue* bigBetaLeftColumn = theCurrentData.GetBigBetaLeftColumn();
+	const G4ChRTableValue* bigBetaRightColumn = theCurrentData.GetBigBetaRightColumn();
+	for (size_t i = 0; i < noOfRIndexValues; i++) {
+		std::cout << '|' << std::setprecision(4) << std::fixed << std::setw(7) << energyColumn[i] / eV << " |"
+			<< std::scientific << std::setw(15) << bigBetaLeftColumn[i] << std::setw(5) << '|'
+			<< std::setw(15) << bigBetaRightColumn[i] << std::setw(7) << "|\n";
+	}
+	std::cout << '|' << std::setfill('_') << std::setw(9) << '|' << std::setw(20) << '|' << std::setw(22) << "|\n";
+}
+
+// n(E) between nodes k - 1 and k (b = 0 -> 1), exactly as G4PhysicsVector::Value() interpolates it, i.e., a cubic
+// spline if second derivatives are filled (G4PhysicsVector::FillSecondDerivatives), otherwise linear
+static inline G4double InterpolateRIndexSegment(const G4double b, const size_t k, const std::vector<G4double>& energyVec,
+	const std::vector<G4double>& RIVector, const std::vector<G4double>& secDerivative) {
+	G4double value = RIVector[k - 1] + b * (RIVector[k] - RIVector[k - 1]);
+	if (!secDerivative.empty()) {
+		const G4double segmentWidth = energyVec[k] - energyVec[k - 1];
+		value += b * (b - 1.) * ((2. - b) * secDerivative[k - 1] + (1. + b) * secDerivative[k]) * segmentWidth * segmentWidth / 6.;
+	}
+	return value;
+}
+
+// adds \int dE and \int dE / RIndex^2 of the segment between nodes k - 1 and k, where beta * RIndex >= 1
+// the integrals are exact for the interpolated RIndex (the threshold crossing as well), so much coarser
+// RIndex tabulation gives the same accuracy as the trapezoidal rule:
+// 1. linear RIndex -> analytically, \int dE / (a + b * E)^2 = (E2 - E1) / (n(E1) * n(E2))
+// 2. spline RIndex -> crossings are found by bisection and 1 / RIndex^2 is integrated with 4-point Gauss-Legendre
+static void IntegrateSegmentExactly(const G4double beta, const size_t k, const std::vector<G4double>& energyVec,
+	const std::vector<G4double>& RIVector, const std::vector<G4double>& secDerivative, G4double& deltaE, G4double& ChRIntensity) {
+	const G4double segmentWidth = energyVec[k] - energyVec[k - 1];
+	if (secDerivative.empty()) {
+		const G4double preTemp = beta * RIVector[k - 1];
+		const G4double postTemp = beta * RIVector[k];
+		if (preTemp < 1. && postTemp < 1.)
+			return;
+		G4double lowB = 0.;
+		G4double highB = 1.;
+		//boundary condition: RIndex = 1 / beta
+		if (preTemp < 1.)
+			lowB = (1. / beta - RIVector[k - 1]) / (RIVector[k] - RIVector[k - 1]);
+		else if (postTemp < 1.)
+			highB = (1. / beta - RIVector[k - 1]) / (RIVector[k] - RIVector[k - 1]);
+		const G4double lowRIndex = preTemp < 1. ? 1. / beta : RIVector[k - 1] + lowB * (RIVector[k] - RIVector[k - 1]);
+		const G4double highRIndex = postTemp < 1. ? 1. / beta : RIVector[k - 1] + highB * (RIVector[k] - RIVector[k - 1]);
+		deltaE += (highB - lowB) * segmentWidth;
+		ChRIntensity += (highB - lowB) * segmentWidth / (lowRIndex * highRIndex);
+		return;
+	}
+	constexpr G4double gaussNodes[4] = { -0.8611363115940526, -0.3399810435848563, 0.3399810435848563, 0.8611363115940526 };
+	constexpr G4double gaussWeights[4] = { 0.3478548451374538, 0.6521451548625461, 0.6521451548625461, 0.3478548451374538 };
+	auto ChRCondition = [&](const G4double b) {
+		return beta * InterpolateRIndexSegment(b, k, energyVec, RIVector, secDerivative) - 1.;
+	};
+	G4double pieceLow = 0.;
+	G4double conditionLow = ChRCondition(pieceLow);
+	for (unsigned int i = 1; i <= o_noOfSplinePieces; i++) {
+		const G4double pieceHigh = (G4double)i / o_noOfSplinePieces;
+		const G4double conditionHigh = ChRCondition(pieceHigh);
+		G4double lowB = pieceLow;
+		G4double highB = pieceHigh;
+		if ((conditionLow >= 0.) != (conditionHigh >= 0.)) {
+			G4double rootLow = pieceLow;
+			G4double rootHigh = pieceHigh;
+			for (unsigned int j = 0; j < o_noOfRootBisections; j++) {
+				const G4double rootMiddle = 0.5 * (rootLow + rootHigh);
+				if ((ChRCondition(rootMiddle) >= 0.) == (conditionLow >= 0.))
+					rootLow = rootMiddle;
+				else
+					rootHigh = rootMiddle;
+			}
+			if (conditionLow >= 0.)
+				highB = 0.5 * (rootLow + rootHigh);
+			else
+				lowB = 0.5 * (rootLow + rootHigh);
+		}
+		else if (conditionLow < 0.)
+			lowB = highB; // no ChR in this piece
+		if (highB > lowB) {
+			const G4double halfWidth = 0.5 * (highB - lowB);
+			const G4double middleB = 0.5 * (highB + lowB);
+			G4double sum = 0.;
+			for (unsigned int j = 0; j < 4; j++)
+				sum += gaussWeights[j] / pow2(InterpolateRIndexSegment(middleB + halfWidth * gaussNodes[j], k, energyVec, RIVector, secDerivative));
+			deltaE += (highB - lowB) * segmentWidth;
+			ChRIntensity += halfWidth * segmentWidth * sum;
+		}
+		pieceLow = pieceHigh;
+		conditionLow = conditionHigh;
+	}
+}
+
+static void IntegrateBetaNode(const G4double beta, const std::vector<G4double>& energyVec, const std::vector<G4double>& RIVector,
+	const std::vector<G4double>* secDerivative, G4double& deltaE, G4double& ChRIntensity, G4double* aCDFRow,
+	G4double* bigBetaLeftColumn, G4double* bigBetaRightColumn) {
+	deltaE = 0.;
+	ChRIntensity = 0.;
+	if (aCDFRow)
+		aCDFRow[0] = 0.;
+	if (bigBetaLeftColumn) {
+		bigBetaLeftColumn[0] = 0.;
+		bigBetaRightColumn[0] = 0.;
+	}
+	for (size_t k = 1; k < RIVector.size(); k++) {
+		if (secDerivative) {
+			IntegrateSegmentExactly(beta, k, energyVec, RIVector, *secDerivative, deltaE, ChRIntensity);
+		}
+		else {
+			//the following two are for the ChR condition
+			G4double preTemp = beta * RIVector[k - 1];
+			G4double postTemp = beta * RIVector[k];
+			if (preTemp >= 1. && postTemp >= 1.) {
+				ChRIntensity += (energyVec[k] - energyVec[k - 1]) * 0.5 *
+					(1 / pow2(RIVector[k]) + 1 / pow2(RIVector[k - 1]));
+				deltaE += energyVec[k] - energyVec[k - 1];
+			}
+			else if (preTemp < 1. && postTemp >= 1.) {
+				//boundary condition: RIndex = 1 / beta
+				G4double tempE = G4LinearInterpolate2D_GetX(RIVector[k - 1], RIVector[k], energyVec[k - 1], energyVec[k], 1 / beta);
+				ChRIntensity += (energyVec[k] - tempE) * 0.5 *
+					(1 / (pow2(1 / beta)) + 1 / (pow2(RIVector[k])));
+				deltaE += energyVec[k] - tempE;
+			}
+			else if (preTemp >= 1. /*&& postTemp < 1.*/) {
+				//boundary condition: RIndex = 1 / beta
+				G4double tempE = G4LinearInterpolate2D_GetX(RIVector[k - 1], RIVector[k], energyVec[k - 1], energyVec[k], 1 / beta);
+				ChRIntensity += (tempE - energyVec[k - 1]) * 0.5 *
+					(1 / pow2(1 / beta) + 1 / pow2(RIVector[k - 1]));
+				deltaE += tempE - energyVec[k - 1];
+			}
+		}
+		if (aCDFRow)
+			aCDFRow[k] = deltaE - ChRIntensity / pow2(beta);
+		if (bigBetaLeftColumn) {
+			bigBetaLeftColumn[k] = deltaE;
+			bigBetaRightColumn[k] = ChRIntensity;
+		}
+	}
+	// normalize to [0., 1.]
+	if (aCDFRow && aCDFRow[RIVector.size() - 1] != 0) { // just for the betaMin row
+		const G4double normValue = aCDFRow[RIVector.size() - 1];
+		for (size_t k = 1; k < RIVector.size(); k++)
+			aCDFRow[k] /= normValue;
+	}
+}
+
+// the error is the larger of the relative photon-yield error (with the yield at betaMax as the scale)
+// and the absolute CDF error, if the middle node is replaced by the linear interpolation
+static G4double GetBetaNodeInterpolationError(const G4ChRAdaptiveBetaNode& lowerNode, const G4ChRAdaptiveBetaNode& middleNode,
+	const G4ChRAdaptiveBetaNode& upperNode, const G4double yieldScale) {
+	const G4double t = (middleNode.m_beta - lowerNode.m_beta) / (upperNode.m_beta - lowerNode.m_beta);
+	const G4double leftIntegral = lowerNode.m_leftIntegral + t * (upperNode.m_leftIntegral - lowerNode.m_leftIntegral);
+	const G4double rightIntegral = lowerNode.m_rightIntegral + t * (upperNode.m_rightIntegral - lowerNode.m_rightIntegral);
+	const G4double invBeta2 = 1. / pow2(middleNode.m_beta);
+	G4double maxError = std::abs((middleNode.m_leftIntegral - middleNode.m_rightIntegral * invBeta2) - (leftIntegral - rightIntegral * invBeta2)) / yieldScale;
+	for (size_t k = 0; k < middleNode.m_CDFRow.size(); k++)
+		maxError = std::max(maxError, std::abs(middleNode.m_CDFRow[k] - (lowerNode.m_CDFRow[k] + t * (upperNode.m_CDFRow[k] - lowerNode.m_CDFRow[k]))));
+	return maxError;
+}
+
+static std::vector<G4ChRAdaptiveBetaNode> BuildAdaptiveBetaNodes(const G4double betaLowLimit, const G4double betaHighLimit, const G4double tolerance,
+	const std::vector<G4double>& energyVec, const std::vector<G4double>& RIVector, const std::vector<G4double>* secDerivative, const G4bool exoticFlag) {
+	auto MakeBetaNode = [&energyVec, &RIVector, secDerivative, exoticFlag](const G4double beta) {
+		G4ChRAdaptiveBetaNode aNode{};
+		aNode.m_beta = beta;
+		if (exoticFlag)
+			aNode.m_CDFRow.resize(energyVec.size());
+		IntegrateBetaNode(beta, energyVec, RIVector, secDerivative, aNode.m_leftIntegral, aNode.m_rightIntegral,
+			exoticFlag ? aNode.m_CDFRow.data() : nullptr);
+		return aNode;
+	};
+	// recursive bisection - nodes between lowerNode and upperNode are added in ascending order
+	std::vector<G4ChRAdaptiveBetaNode> betaNodes{};
+	G4double yieldScale = 0.;
+	std::function<void(const G4ChRAdaptiveBetaNode&, const G4ChRAdaptiveBetaNode&, const unsigned int)> RefineBetaInterval =
+		[&](const G4ChRAdaptiveBetaNode& lowerNode, const G4ChRAdaptiveBetaNode& upperNode, const unsigned int depth) {
+		if (depth >= o_maxAdaptiveBetaDepth)
+			return;
+		G4ChRAdaptiveBetaNode middleNode = MakeBetaNode(0.5 * (lowerNode.m_beta + upperNode.m_beta));
+		if (GetBetaNodeInterpolationError(lowerNode, middleNode, upperNode, yieldScale) <= tolerance)
+			return;
+		RefineBetaInterval(lowerNode, middleNode, depth + 1);
+		betaNodes.push_back(middleNode);
+		RefineBetaInterval(middleNode, upperNode, depth + 1);
+	};
+	const G4double deltaBeta = (betaHighLimit - betaLowLimit) / o_initialNoOfAdaptiveBetaSteps;
+	std::vector<G4ChRAdaptiveBetaNode> initialNodes{};
+	initialNodes.reserve(o_initialNoOfAdaptiveBetaSteps + 1);
+	for (unsigned int j = 0; j <= o_initialNoOfAdaptiveBetaSteps; j++)
+		initialNodes.push_back(MakeBetaNode(j == o_initialNoOfAdaptiveBetaSteps ? betaHighLimit : betaLowLimit + j * deltaBeta));
+	yieldScale = initialNodes.back().m_leftIntegral - initialNodes.back().m_rightIntegral / pow2(betaHighLimit);
+	if (yieldScale <= 0.)
+		yieldScale = 1.;
+	betaNodes.push_back(initialNodes.front());
+	for (unsigned int j = 1; j <= o_initialNoOfAdaptiveBetaSteps; j++) {
+		RefineBetaInterval(initialNodes[j - 1], initialNodes[j], 0);
+		betaNodes.push_back(initialNodes[j]);
+	}
+	return betaNodes;
+}
+
+static const G4AccessPhysicsVector* GetRIndexOfMaterial(const size_t materialID) {
+	const G4MaterialPropertiesTable* MPT = (*G4Material::GetMaterialTable())[materialID]->GetMaterialPropertiesTable();
+	if (!MPT)
+		return nullptr;
+	const G4AccessPhysicsVector* RIndex = reinterpret_cast<const G4AccessPhysicsVector*>(MPT->GetProperty(kRINDEX));
+	if (!RIndex)
+		RIndex = reinterpret_cast<const G4AccessPhysicsVector*>(MPT->GetProperty(kREALRINDEX));
+	return RIndex;
+}
\ No newline at end of file
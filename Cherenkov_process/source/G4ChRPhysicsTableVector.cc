@@ -0,0 +1,81 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+//G4 headers
+#include "G4ChRPhysicsTableVector.hh"
+#include "GlobalFunctions.hh"
+//std:: headers
+#include <unordered_set>
+
+// the table of slots that SetTable adds below materialID, i.e., materials without Cherenkov tables
+static const std::shared_ptr<const G4ChRPhysTableData>& GetEmptyTable();
+
+//=========public G4ChRPhysicsTableVector:: methods=========
+
+size_t G4ChRPhysicsTableVector::BuildTables(const std::vector<std::uint64_t>& materialKeys, G4ChRBuildTableFunction aBuildFunction,
+	const G4ChRSharedTableMap& availableTables) {
+	// the first material with a new key is the one used to build the table
+	std::unordered_map<std::uint64_t, size_t> keyToNewTable;
+	std::vector<size_t> tablesToBuild{};
+	for (size_t materialID = 0; materialID < materialKeys.size(); materialID++) {
+		if (availableTables.find(materialKeys[materialID]) == availableTables.end() &&
+			keyToNewTable.emplace(materialKeys[materialID], tablesToBuild.size()).second)
+			tablesToBuild.push_back(materialID);
+	}
+	std::vector<std::shared_ptr<G4ChRPhysTableData>> newTables(tablesToBuild.size());
+	G4ExecuteInTaskPool(tablesToBuild.size(), [&tablesToBuild, &newTables, aBuildFunction](const size_t i) {
+		newTables[i] = std::make_shared<G4ChRPhysTableData>();
+		aBuildFunction(tablesToBuild[i], false, *newTables[i]);
+		});
+	m_materialTables.resize(materialKeys.size());
+	m_materialKeys = materialKeys;
+	for (size_t materialID = 0; materialID < materialKeys.size(); materialID++) {
+		auto tableIter = availableTables.find(materialKeys[materialID]);
+		if (tableIter != availableTables.end())
+			m_materialTables[materialID] = tableIter->second;
+		else
+			m_materialTables[materialID] = newTables[keyToNewTable[materialKeys[materialID]]];
+	}
+	return tablesToBuild.size();
+}
+
+void G4ChRPhysicsTableVector::SetTable(const size_t materialID, const std::uint64_t materialKey, G4ChRPhysTableData&& aTable) {
+	if (materialID >= m_materialTables.size()) {
+		// operator[] must not find null tables in the gap (e.g., G4CherenkovProcess::ResolveAllOptics goes through all materials)
+		m_materialTables.resize(materialID + 1, GetEmptyTable());
+		m_materialKeys.resize(materialID + 1);
+	}
+	m_materialTables[materialID] = std::make_shared<const G4ChRPhysTableData>(std::move(aTable));
+	m_materialKeys[materialID] = materialKey;
+}
+
+size_t G4ChRPhysicsTableVector::GetNoOfUniqueTables() const {
+	std::unordered_set<const G4ChRPhysTableData*> uniqueTables;
+	for (const auto& aTable : m_materialTables) {
+		if (aTable != GetEmptyTable())
+			uniqueTables.insert(aTable.get());
+	}
+	return uniqueTables.size();
+}
+
+G4ChRPhysicsTableVector::G4ChRSharedTableMap G4ChRPhysicsTableVector::GetSharedTables() const {
+	G4ChRSharedTableMap sharedTables;
+	for (size_t materialID = 0; materialID < m_materialTables.size(); materialID++) {
+		// materials added by SetTable (without BuildTables) may leave slots with the empty table
+		if (m_materialTables[materialID] != GetEmptyTable())
+			sharedTables.emplace(m_materialKeys[materialID], m_materialTables[materialID]);
+	}
+	return sharedTables;
+}
+
+//=========static methods of translation unit=========
+
+static const std::shared_ptr<const G4ChRPhysTableData>& GetEmptyTable() {
+	static const std::shared_ptr<const G4ChRPhysTableData> anEmptyTable = std::make_shared<const G4ChRPhysTableData>();
+	return anEmptyTable;
+}
\ No newline at end of file
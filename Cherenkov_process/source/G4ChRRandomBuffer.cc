@@ -0,0 +1,183 @@
+//##########################################
+//#######         VERSION 0.6        #######
+//#######    Used: Geant4 v11.1 MT   #######
+//#######   Tested on MSVC compiler  #######
+//#######    Author: Djurnic Blazo   #######
+//####### Contact: zobla96@gmail.com #######
+//##########################################
+
+//G4 headers
+#include "G4ChRRandomBuffer.hh"
+#include "G4Poisson.hh"
+#include "G4Track.hh"
+#include "G4EventManager.hh"
+#include "G4Event.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4Exp.hh"
+#include "G4Log.hh"
+#include "G4PhysicalConstants.hh"
+//std:: headers
+#include <algorithm>
+#include <atomic>
+
+// shared by all threads, and changed only between runs
+static std::atomic<G4bool> o_isCounterBasedModeEnabled{ false };
+static std::atomic<G4long> o_counterBasedSeed{ 0 };
+
+//Philox4x32 constants (Salmon et al.)
+static constexpr std::uint32_t o_philoxM0 = 0xD2511F53;
+static constexpr std::uint32_t o_philoxM1 = 0xCD9E8D57;
+static constexpr std::uint32_t o_philoxW0 = 0x9E3779B9;
+static constexpr std::uint32_t o_philoxW1 = 0xBB67AE85;
+static constexpr unsigned char o_philoxRounds = 10;
+
+// SplitMix64 finalizer; spreads seeds that differ in a few bits over the whole key
+static std::uint64_t HashSeed(std::uint64_t aValue) {
+	aValue += 0x9E3779B97F4A7C15ULL;
+	aValue = (aValue ^ (aValue >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	aValue = (aValue ^ (aValue >> 27)) * 0x94D049BB133111EBULL;
+	return aValue ^ (aValue >> 31);
+}
+
+static void Philox4x32(std::uint32_t counter[4], std::uint32_t key0, std::uint32_t key1) {
+	for (unsigned char i = 0; i < o_philoxRounds; i++) {
+		const std::uint64_t product0 = static_cast<std::uint64_t>(o_philoxM0) * counter[0];
+		const std::uint64_t product1 = static_cast<std::uint64_t>(o_philoxM1) * counter[2];
+		const std::uint32_t hi0 = static_cast<std::uint32_t>(product0 >> 32);
+		const std::uint32_t lo0 = static_cast<std::uint32_t>(product0);
+		const std::uint32_t hi1 = static_cast<std::uint32_t>(product1 >> 32);
+		const std::uint32_t lo1 = static_cast<std::uint32_t>(product1);
+		counter[0] = hi1 ^ counter[1] ^ key0;
+		counter[1] = lo1;
+		counter[2] = hi0 ^ counter[3] ^ key1;
+		counter[3] = lo0;
+		key0 += o_philoxW0;
+		key1 += o_philoxW1;
+	}
+}
+
+// 53 random bits in (0, 1), i.e., 0 and 1 are never returned (as with CLHEP engines)
+static G4double ToFlat(const std::uint32_t hi, const std::uint32_t lo) {
+	const std::uint64_t bits = ((static_cast<std::uint64_t>(hi) << 32) | lo) >> 11;
+	return (static_cast<G4double>(bits) + 0.5) * 0x1.0p-53;
+}
+
+//=========public G4ChRRandomBuffer:: methods=========
+
+void G4ChRRandomBuffer::Prefetch(const size_t count) {
+	const size_t noOfBuffered = m_end - m_position;
+	if (noOfBuffered >= count)
+		return;
+	// unused numbers are moved to the front, so no drawn number is wasted
+	if (m_position != 0) {
+		std::copy(m_values.begin() + m_position, m_values.begin() + m_end, m_values.begin());
+		m_position = 0;
+		m_end = noOfBuffered;
+	}
+	if (m_values.size() < count)
+		m_values.resize(count); // never shrunk
+	CLHEP::HepRandom::getTheEngine()->flatArray(static_cast<G4int>(count - noOfBuffered), m_values.data() + m_end);
+	m_end = count;
+}
+
+G4long G4ChRRandomBuffer::Poisson(const G4double mean) {
+	if (!m_isCounterBased)
+		return G4Poisson(mean); // the same numbers as before, so engine-mode runs are not changed
+	// G4Poisson (Geant4 11.1) with Flat instead of G4UniformRand
+	SelectStream(m_stepStreamID);
+	constexpr G4int border = 16;
+	constexpr G4double limit = 2e9;
+	G4long number = 0;
+	if (mean <= border) {
+		const G4double position = Flat();
+		G4double poissonValue = G4Exp(-mean);
+		G4double poissonSum = poissonValue;
+		while (poissonSum <= position) {
+			++number;
+			poissonValue *= mean / number;
+			poissonSum += poissonValue;
+		}
+		return number;
+	}
+	G4double t = std::sqrt(-2. * G4Log(Flat()));
+	const G4double y = CLHEP::twopi * Flat();
+	t *= std::cos(y);
+	const G4double value = mean + t * std::sqrt(mean) + 0.5;
+	if (value <= 0.)
+		return 0;
+	return (value >= limit) ? static_cast<G4long>(limit) : static_cast<G4long>(value);
+}
+
+//=======Counter-based mode=======
+
+void G4ChRRandomBuffer::EnableCounterBasedMode(const G4long seed) {
+	o_counterBasedSeed = seed;
+	o_isCounterBasedModeEnabled = true;
+}
+
+void G4ChRRandomBuffer::DisableCounterBasedMode() {
+	o_isCounterBasedModeEnabled = false;
+}
+
+G4bool G4ChRRandomBuffer::IsCounterBasedModeEnabled() {
+	return o_isCounterBasedModeEnabled;
+}
+
+G4long G4ChRRandomBuffer::GetCounterBasedSeed() {
+	return o_counterBasedSeed;
+}
+
+void G4ChRRandomBuffer::BeginStep(const G4Track& aTrack) {
+	m_isCounterBased = o_isCounterBasedModeEnabled;
+	if (!m_isCounterBased)
+		return;
+	// event IDs restart in each run, so the run ID is a part of the key (the seed can be changed only between runs)
+	const G4Run* aRun = G4RunManager::GetRunManager()->GetCurrentRun();
+	const G4int runID = aRun ? aRun->GetRunID() : -1;
+	if (runID != m_runID || !m_hasRunKey) {
+		m_runID = runID;
+		m_runKey = HashSeed(HashSeed(static_cast<std::uint64_t>(o_counterBasedSeed.load())) + static_cast<std::uint64_t>(static_cast<std::uint32_t>(runID)));
+		m_hasRunKey = true;
+	}
+	m_key[0] = static_cast<std::uint32_t>(m_runKey);
+	m_key[1] = static_cast<std::uint32_t>(m_runKey >> 32) ^ static_cast<std::uint32_t>(aTrack.GetCurrentStepNumber());
+	const G4Event* anEvent = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+	m_eventID = static_cast<std::uint32_t>(anEvent ? anEvent->GetEventID() : -1);
+	m_trackID = static_cast<std::uint32_t>(aTrack.GetTrackID());
+	m_position = m_end = 0;
+	SelectStream(m_stepStreamID);
+}
+
+void G4ChRRandomBuffer::FillStreams(G4double* first, G4double* second, const size_t count, const std::uint32_t block) const {
+	// independent iterations, so the loop can be vectorized or split
+	for (size_t i = 0; i < count; i++)
+		ComputeCounterBlock(static_cast<std::uint32_t>(i), block, first[i], second[i]);
+}
+
+//=========private G4ChRRandomBuffer:: methods=========
+
+void G4ChRRandomBuffer::ComputeCounterBlock(const std::uint32_t streamID, const std::uint32_t block, G4double& first, G4double& second) const {
+	std::uint32_t counter[4] = { streamID, block, m_trackID, m_eventID };
+	Philox4x32(counter, m_key[0], m_key[1]);
+	first = ToFlat(counter[0], counter[1]);
+	second = ToFlat(counter[2], counter[3]);
+}
+
+G4double G4ChRRandomBuffer::NextCounterFlat() {
+	if (m_hasCachedDraw && (m_draw & 1)) {
+		m_hasCachedDraw = false;
+		m_draw++;
+		return m_cachedDraw;
+	}
+	G4double first, second;
+	ComputeCounterBlock(m_streamID, m_draw >> 1, first, second);
+	if (m_draw & 1) {
+		m_draw++;
+		return second;
+	}
+	m_cachedDraw = second;
+	m_hasCachedDraw = true;
+	m_draw++;
+	return first;
+}
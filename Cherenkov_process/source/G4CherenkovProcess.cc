@@ -13,6 +13,8 @@
 #include "G4SystemOfUnits.hh"
 #include "G4StandardChR_Model.hh"
 #include "G4ThinTargetChR_Model.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4OpticalParameters.hh"
 
 //=========public G4CherenkovProcess:: methods=========
 
@@ -99,4 +101,61 @@ void G4CherenkovProcess::ProcessDescription(std::ostream& outStream) const {
 		"3. A.P. Kobzev \"On the radiation mechanism of a uniformly moving charge\", Phys. Part. Nucl. 45(3), (2014) 628-653\n\n"
 		"End of G4CherenkovProcess::ProcessDescription()\n"
 	<< std::setw(116) << '\n' << std::endl;
+}
+
+//=========private G4CherenkovProcess:: methods=========
+
+void G4CherenkovProcess::ResolveAllOptics() {
+	m_ChRMatDataGeneration = G4ExtraOpticalParameters::GetChRMatDataGeneration();
+	m_resolvedOptics.clear();
+	p_selectedLogicVolume = nullptr;
+	p_selectedOptics = nullptr;
+	for (const G4LogicalVolume* aLogicVolume : *G4LogicalVolumeStore::GetInstance())
+		FindOrResolveOptics(aLogicVolume);
+}
+
+G4ChRResolvedOptics& G4CherenkovProcess::FindOrResolveOptics(const G4LogicalVolume* aLogicVolume) {
+	auto foundOptics = m_resolvedOptics.find(aLogicVolume);
+	if (foundOptics != m_resolvedOptics.end())
+		return foundOptics->second;
+
+	// the following might be a problem if the rebuilding geometry and adding new LV in later phases
+	const std::shared_ptr<G4ExtraOpticalParameters> extraOptParameters = G4ExtraOpticalParameters::GetInstance();
+	const G4CherenkovMatData& matData = extraOptParameters->FindOrCreateChRMatData(aLogicVolume);
+	if (matData.m_executeModel >= m_registeredModels.size()) {
+		std::ostringstream err;
+		err << "A Cherenkov model with ID: " << matData.m_executeModel << " not found while you are trying to execute it!\n";
+		G4Exception("G4CherenkovProcess::FindOrResolveOptics", "FE_ChRProcess01", FatalException, err);
+	}
+	const G4ChRPhysicsTableVector& physDataVec = m_ChRPhysDataSnapshot.Get();
+	const G4Material* aMaterial = aLogicVolume->GetMaterial();
+	if (aMaterial->GetIndex() >= physDataVec.size()) {
+		const char* err = "Not all materials have been registered in Cherenkov physics tables!\n";
+		G4Exception("G4CherenkovProcess::FindOrResolveOptics", "FE_ChRProcess02", FatalException, err);
+	}
+
+	G4ChRResolvedOptics& theOptics = m_resolvedOptics[aLogicVolume];
+	theOptics.p_executeModel = m_registeredModels[matData.m_executeModel];
+	theOptics.p_physData = &physDataVec[aMaterial->GetIndex()];
+	if (const G4MaterialPropertiesTable* matPropTab = aMaterial->GetMaterialPropertiesTable()) {
+		theOptics.p_RIndex = matPropTab->GetProperty(kRINDEX);
+		if (!theOptics.p_RIndex)
+			theOptics.p_RIndex = matPropTab->GetProperty(kREALRINDEX);
+	}
+	if (theOptics.p_RIndex) {
+		theOptics.m_minEnergy = theOptics.p_RIndex->Energy(0);
+		theOptics.m_maxEnergy = theOptics.p_RIndex->GetMaxEnergy();
+	}
+	theOptics.p_middlePoint = matData.p_middlePoint;
+	theOptics.m_halfThickness = matData.m_halfThickness;
+	theOptics.m_minAxis = matData.m_minAxis;
+	theOptics.m_exoticRIndex = matData.m_exoticRIndex;
+	theOptics.m_exoticInitialFlag = matData.m_exoticFlagInital;
+	theOptics.m_thinningFactor = extraOptParameters->GetThinningFactor(matData);
+	theOptics.m_useCDFSampling = matData.m_exoticRIndex ||
+		(!G4ChRPhysicsTableService::GetUseRejectionSampling() && theOptics.p_physData->HasCDFTables());
+	const G4OpticalParameters* optParameters = G4OpticalParameters::Instance();
+	theOptics.m_stackPhotons = optParameters->GetCerenkovStackPhotons();
+	theOptics.m_trackSecondariesFirst = optParameters->GetCerenkovTrackSecondariesFirst();
+	return theOptics;
 }
\ No newline at end of file
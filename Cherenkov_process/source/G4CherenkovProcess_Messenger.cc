@@ -9,9 +9,12 @@
 //G4 headers
 #include "G4CherenkovProcess_Messenger.hh"
 #include "G4CherenkovProcess.hh"
+#include "G4ChRPhotonPool.hh"
+#include "G4ChRRandomBuffer.hh"
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIparameter.hh"
 #include "G4ParticleTable.hh"
@@ -85,6 +88,16 @@ G4CherenkovProcess_Messenger::G4CherenkovProcess_Messenger(G4CherenkovProcess* t
 	p_noOfBetaSteps->SetToBeBroadcasted(false);
 	p_noOfBetaSteps->AvailableForStates(G4State_Idle);
 
+	p_betaGridTolerance = new G4UIcmdWithADouble{ "/process/optical/G4ChRProcess/Models/betaGridTolerance", this };
+	p_betaGridTolerance->SetGuidance("Used to build adaptive beta grids for physics tables of BaseChR_Model (instead of noOfBetaSteps).");
+	p_betaGridTolerance->SetGuidance("Beta nodes are added only where the photon yield (relative to the yield at betaMax) or CDF values");
+	p_betaGridTolerance->SetGuidance("deviate from the linear interpolation by more than the tolerance, e.g., near Cherenkov thresholds.");
+	p_betaGridTolerance->SetGuidance("tolerance == 0 -> uniform beta grids with noOfBetaSteps are used (default)");
+	p_betaGridTolerance->SetParameterName("tolerance", false);
+	p_betaGridTolerance->SetRange("tolerance>=0 && tolerance<1");
+	p_betaGridTolerance->SetToBeBroadcasted(false);
+	p_betaGridTolerance->AvailableForStates(G4State_Idle);
+
 	p_modelVerboseLevel = new G4UIcmdWithAnInteger{ "/process/optical/G4ChRProcess/Models/changeModelVerbose", this };
 	p_modelVerboseLevel->SetGuidance("Used to change the verbose level for all registered models.");
 	p_modelVerboseLevel->SetParameterName("verboseLevel", true);
@@ -93,6 +106,50 @@ G4CherenkovProcess_Messenger::G4CherenkovProcess_Messenger(G4CherenkovProcess* t
 	p_modelVerboseLevel->SetToBeBroadcasted(true);
 	p_modelVerboseLevel->AvailableForStates(G4State_Idle);
 
+	p_useAliasSampler = new G4UIcommand{ "/process/optical/G4ChRProcess/Models/useAliasSampler", this };
+	p_useAliasSampler->SetGuidance("Used to select the energy sampler of exotic refractive indices for a registered model.");
+	p_useAliasSampler->SetGuidance("true -> Walker/Vose alias tables (O(1) per photon), false -> inverse CDF (binary search).");
+	p_useAliasSampler->SetGuidance("Both samplers give the same spectral distribution.");
+	uiParameter = new G4UIparameter{ "modelID", 'i', false };
+	uiParameter->SetParameterRange("modelID>=0");
+	p_useAliasSampler->SetParameter(uiParameter);
+	uiParameter = new G4UIparameter{ "useAlias", 'b', true };
+	uiParameter->SetDefaultValue("true");
+	p_useAliasSampler->SetParameter(uiParameter);
+	p_useAliasSampler->SetToBeBroadcasted(true);
+	p_useAliasSampler->AvailableForStates(G4State_Idle);
+
+	p_useRejectionSampling = new G4UIcmdWithABool{ "/process/optical/G4ChRProcess/Models/useRejectionSampling", this };
+	p_useRejectionSampling->SetGuidance("Used to select the energy sampler of non-exotic refractive indices for all models.");
+	p_useRejectionSampling->SetGuidance("false -> CDF tables are built for all materials and inverted above the threshold energy (one draw per photon)");
+	p_useRejectionSampling->SetGuidance("true -> the old sampler (uniform energies rejected until beta * RIndex > 1) - kept for validation");
+	p_useRejectionSampling->SetGuidance("Physics tables of BaseChR_Model are rebuilt after the change.");
+	p_useRejectionSampling->SetParameterName("useRejection", true);
+	p_useRejectionSampling->SetDefaultValue(true);
+	p_useRejectionSampling->SetToBeBroadcasted(false);
+	p_useRejectionSampling->AvailableForStates(G4State_Idle);
+
+	p_useExactIntegration = new G4UIcmdWithABool{ "/process/optical/G4ChRProcess/Models/useExactIntegration", this };
+	p_useExactIntegration->SetGuidance("Used to select the integration of Cherenkov physics tables for all models.");
+	p_useExactIntegration->SetGuidance("false -> the trapezoidal rule between RIndex nodes");
+	p_useExactIntegration->SetGuidance("true -> exact integrals of the interpolated RIndex (linear or spline, if RINDEX has second derivatives)");
+	p_useExactIntegration->SetGuidance("Physics tables of BaseChR_Model are rebuilt after the change.");
+	p_useExactIntegration->SetParameterName("useExact", true);
+	p_useExactIntegration->SetDefaultValue(true);
+	p_useExactIntegration->SetToBeBroadcasted(false);
+	p_useExactIntegration->AvailableForStates(G4State_Idle);
+
+	p_noOfRIndexGridNodes = new G4UIcmdWithAnInteger{ "/process/optical/G4ChRProcess/Models/noOfRIndexGridNodes", this };
+	p_noOfRIndexGridNodes->SetGuidance("Used to resample RIndex onto a uniform energy grid for faster RIndex(E) of generated photons.");
+	p_noOfRIndexGridNodes->SetGuidance("RIndex is then found by direct indexing, i.e., without the bin search of G4PhysicsVector::Value.");
+	p_noOfRIndexGridNodes->SetGuidance("gridNodes < 2 -> RIndex vectors are used directly (default)");
+	p_noOfRIndexGridNodes->SetGuidance("The max. error of the resampled RIndex is printed with physics tables (verbose level >= 1).");
+	p_noOfRIndexGridNodes->SetGuidance("Physics tables of BaseChR_Model are rebuilt after the change.");
+	p_noOfRIndexGridNodes->SetParameterName("gridNodes", false);
+	p_noOfRIndexGridNodes->SetRange("gridNodes>=0");
+	p_noOfRIndexGridNodes->SetToBeBroadcasted(false);
+	p_noOfRIndexGridNodes->AvailableForStates(G4State_Idle);
+
 	p_printPhysicsVector = new G4UIcommand{ "/process/optical/G4ChRProcess/Models/printBaseChRPhysicsVector", this };
 	p_printPhysicsVector->SetGuidance("Used to print the loaded static physics vector of BaseChR_model.");
 	p_printPhysicsVector->SetGuidance("Used to print the loaded static physics vector of G4StandardChRProcess.");
@@ -108,6 +165,56 @@ G4CherenkovProcess_Messenger::G4CherenkovProcess_Messenger(G4CherenkovProcess* t
 	p_printPhysicsVector->SetParameter(uiParameter);
 	p_printPhysicsVector->SetToBeBroadcasted(false);
 	p_printPhysicsVector->AvailableForStates(G4State_Idle);
+
+	p_validatePhysicsTables = new G4UIcommand{ "/process/optical/G4ChRProcess/Models/validatePhysicsTables", this };
+	p_validatePhysicsTables->SetGuidance("Used to compare the stored physics tables with the double-precision integration at all beta nodes.");
+	p_validatePhysicsTables->SetGuidance("Prints the max. errors of photon yields and spectra (CDFs) and the memory of the tables.");
+	p_validatePhysicsTables->SetGuidance("It's meant for float tables, i.e., a library built with USE_FLOAT_CHR_TABLES.");
+	p_validatePhysicsTables->SetToBeBroadcasted(false);
+	p_validatePhysicsTables->AvailableForStates(G4State_Idle);
+
+	p_usePhotonPool = new G4UIcmdWithAnInteger{ "/process/optical/G4ChRProcess/Models/usePhotonPool", this };
+	p_usePhotonPool->SetGuidance("Used to select the allocation strategy of optical photons of all models (and G4StandardCherenkovProcess).");
+	p_usePhotonPool->SetGuidance("pageFactor == 0 -> default Geant4 allocation (already enlarged pool pages are kept)");
+	p_usePhotonPool->SetGuidance("pageFactor == 1 -> secondary lists are reserved for the largest number of photons in the event");
+	p_usePhotonPool->SetGuidance("pageFactor >= 2 -> the previous + G4Track and G4DynamicParticle pool pages are pageFactor times larger");
+	p_usePhotonPool->SetGuidance("Pages can be increased only once per thread (see G4ChRPhotonPool.hh).");
+	p_usePhotonPool->SetParameterName("pageFactor", true);
+	p_usePhotonPool->SetDefaultValue(16);
+	p_usePhotonPool->SetRange("pageFactor>=0 && pageFactor<=1024");
+	p_usePhotonPool->SetToBeBroadcasted(true);
+	p_usePhotonPool->AvailableForStates(G4State_Idle);
+
+	p_forceEmissionTo = new G4UIcommand{ "/process/optical/G4ChRProcess/Models/forceEmissionTo", this };
+	p_forceEmissionTo->SetGuidance("Used to direct Cherenkov photons of a registered model towards a target physical volume (e.g., a detector).");
+	p_forceEmissionTo->SetGuidance("Photons are generated only in the cone of directions that reach the target after refraction");
+	p_forceEmissionTo->SetGuidance("at the exit face of the radiator, and they have weights (see G4ChRForcedEmission.hh).");
+	p_forceEmissionTo->SetGuidance("targetName == none -> photons are not directed");
+	uiParameter = new G4UIparameter{ "modelID", 'i', false };
+	uiParameter->SetParameterRange("modelID>=0");
+	p_forceEmissionTo->SetParameter(uiParameter);
+	uiParameter = new G4UIparameter{ "targetName", 's', false };
+	p_forceEmissionTo->SetParameter(uiParameter);
+	uiParameter = new G4UIparameter{ "outsideRIndex", 'd', true };
+	uiParameter->SetGuidance("The refractive index behind the exit face of the radiator.");
+	uiParameter->SetParameterRange("outsideRIndex>0.");
+	uiParameter->SetDefaultValue(1.);
+	p_forceEmissionTo->SetParameter(uiParameter);
+	p_forceEmissionTo->SetToBeBroadcasted(true);
+	p_forceEmissionTo->AvailableForStates(G4State_Idle);
+
+	p_useCounterBasedRNG = new G4UIcommand{ "/process/optical/G4ChRProcess/Models/useCounterBasedRNG", this };
+	p_useCounterBasedRNG->SetGuidance("Used to select the random numbers of Cherenkov photons of all models (and G4StandardCherenkovProcess).");
+	p_useCounterBasedRNG->SetGuidance("true -> counter-based numbers (Philox4x32-10), i.e., a pure function of (seed, run, event, track ID, step number, photon)");
+	p_useCounterBasedRNG->SetGuidance("false -> numbers of the thread engine (default)");
+	p_useCounterBasedRNG->SetGuidance("Photons don't depend on thread scheduling, and a job with the same seed reproduces them (see G4ChRRandomBuffer.hh).");
+	uiParameter = new G4UIparameter{ "useCounterBased", 'b', false };
+	p_useCounterBasedRNG->SetParameter(uiParameter);
+	uiParameter = new G4UIparameter{ "seed", 'l', true };
+	uiParameter->SetDefaultValue("0");
+	p_useCounterBasedRNG->SetParameter(uiParameter);
+	p_useCounterBasedRNG->SetToBeBroadcasted(false); // shared by all threads
+	p_useCounterBasedRNG->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 
 G4CherenkovProcess_Messenger::~G4CherenkovProcess_Messenger() {
@@ -122,8 +229,17 @@ G4CherenkovProcess_Messenger::~G4CherenkovProcess_Messenger() {
 	//G4BaseChR_Model commands
 	delete p_useEnergyLossInModels;
 	delete p_noOfBetaSteps;
+	delete p_betaGridTolerance;
 	delete p_modelVerboseLevel;
+	delete p_useAliasSampler;
+	delete p_useRejectionSampling;
+	delete p_useExactIntegration;
+	delete p_noOfRIndexGridNodes;
 	delete p_printPhysicsVector;
+	delete p_validatePhysicsTables;
+	delete p_usePhotonPool;
+	delete p_forceEmissionTo;
+	delete p_useCounterBasedRNG;
 }
 
 void G4CherenkovProcess_Messenger::SetNewValue(G4UIcommand* uiCmd, G4String aStr) {
@@ -209,35 +325,87 @@ void G4CherenkovProcess_Messenger::SetNewValue(G4UIcommand* uiCmd, G4String aStr
 	}
 	else if (uiCmd == p_noOfBetaSteps) {
 		const unsigned int newBetaStep = std::stoul(aStr);
-		if (newBetaStep == G4BaseChR_Model::GetNoOfBetaSteps()) {
+		if (newBetaStep == G4ChRPhysicsTableService::GetNoOfBetaSteps()) {
 			const char* msg = "betaStep of Cherenkov models has not been changed - you used the same number that's already set!\n";
 			G4Exception("G4CherenkovProcess_Messenger::SetNewValue", "WE_ChRMessenger04", JustWarning, msg);
 			return;
 		}
-		G4BaseChR_Model::SetNoOfBetaSteps(newBetaStep);
+		G4ChRPhysicsTableService::SetNoOfBetaSteps(newBetaStep);
 		if ((*p_ChRProcess->m_registeredModels.begin())->GetVerboseLevel() > 0)
 			std::cout << "The betaStep value has been changed! Now deleting old physics tables...\n";
-		const_cast<G4BaseChR_Model::G4ChRPhysicsTableVector&>(G4BaseChR_Model::GetChRPhysDataVec()).clear();
-		if ((*p_ChRProcess->m_registeredModels.begin())->GetVerboseLevel() > 0)
-			std::cout << "Old physics tables have been removed! Now creating new physics tables...\n";
-		auto* particleIterator = G4ParticleTable::GetParticleTable()->GetIterator();
-		particleIterator->reset();
-		while ((*particleIterator)()) { //a useless and bad loop for this process, but still... pre-run time
-			(*p_ChRProcess->m_registeredModels.begin())->BuildModelPhysicsTable(*(particleIterator->value()));
+		RebuildBaseChRPhysicsTables();
+	}
+	else if (uiCmd == p_betaGridTolerance) {
+		const G4double newTolerance = p_betaGridTolerance->ConvertToDouble(aStr);
+		if (newTolerance == G4ChRPhysicsTableService::GetBetaGridTolerance()) {
+			const char* msg = "betaGridTolerance of Cherenkov models has not been changed - you used the same number that's already set!\n";
+			G4Exception("G4CherenkovProcess_Messenger::SetNewValue", "WE_ChRMessenger07", JustWarning, msg);
+			return;
 		}
-		if((*p_ChRProcess->m_registeredModels.begin())->GetVerboseLevel() > 0)
-			std::cout << "Physics tables have been successfully rebuilt!\n";
+		G4ChRPhysicsTableService::SetBetaGridTolerance(newTolerance);
+		if ((*p_ChRProcess->m_registeredModels.begin())->GetVerboseLevel() > 0)
+			std::cout << "The betaGridTolerance value has been changed! Now deleting old physics tables...\n";
+		RebuildBaseChRPhysicsTables();
 	}
 	else if (uiCmd == p_modelVerboseLevel) {
 		const unsigned char newValue = (const unsigned char)p_modelVerboseLevel->ConvertToInt(aStr);
 		for (auto* aModel : p_ChRProcess->m_registeredModels)
 			aModel->SetVerboseLevel(newValue);
 	}
+	else if (uiCmd == p_useAliasSampler) {
+		std::istringstream iss{ aStr };
+		size_t modelID;
+		std::string useAlias;
+		iss >> modelID >> useAlias;
+		if (modelID >= p_ChRProcess->m_registeredModels.size()) {
+			std::ostringstream err;
+			err << "A Cherenkov model with ID: " << modelID << " is not registered! The sampler has not been changed.\n";
+			G4Exception("G4CherenkovProcess_Messenger::SetNewValue", "WE_ChRMessenger08", JustWarning, err);
+			return;
+		}
+		p_ChRProcess->m_registeredModels[modelID]->SetUseAliasSampler(G4UIcommand::ConvertToBool(useAlias.c_str()));
+	}
+	else if (uiCmd == p_useRejectionSampling) {
+		const G4bool newValue = p_useRejectionSampling->ConvertToBool(aStr);
+		if (newValue == G4ChRPhysicsTableService::GetUseRejectionSampling()) {
+			const char* msg = "useRejectionSampling of Cherenkov models has not been changed - you used the value that's already set!\n";
+			G4Exception("G4CherenkovProcess_Messenger::SetNewValue", "WE_ChRMessenger09", JustWarning, msg);
+			return;
+		}
+		G4ChRPhysicsTableService::SetUseRejectionSampling(newValue);
+		if ((*p_ChRProcess->m_registeredModels.begin())->GetVerboseLevel() > 0)
+			std::cout << "The useRejectionSampling value has been changed! Now deleting old physics tables...\n";
+		RebuildBaseChRPhysicsTables();
+	}
+	else if (uiCmd == p_useExactIntegration) {
+		const G4bool newValue = p_useExactIntegration->ConvertToBool(aStr);
+		if (newValue == G4ChRPhysicsTableService::GetUseExactIntegration()) {
+			const char* msg = "useExactIntegration of Cherenkov models has not been changed - you used the value that's already set!\n";
+			G4Exception("G4CherenkovProcess_Messenger::SetNewValue", "WE_ChRMessenger10", JustWarning, msg);
+			return;
+		}
+		G4ChRPhysicsTableService::SetUseExactIntegration(newValue);
+		if ((*p_ChRProcess->m_registeredModels.begin())->GetVerboseLevel() > 0)
+			std::cout << "The useExactIntegration value has been changed! Now deleting old physics tables...\n";
+		RebuildBaseChRPhysicsTables();
+	}
+	else if (uiCmd == p_noOfRIndexGridNodes) {
+		const unsigned int newValue = std::stoul(aStr);
+		if (newValue == G4ChRPhysicsTableService::GetNoOfRIndexGridNodes()) {
+			const char* msg = "noOfRIndexGridNodes of Cherenkov models has not been changed - you used the same number that's already set!\n";
+			G4Exception("G4CherenkovProcess_Messenger::SetNewValue", "WE_ChRMessenger11", JustWarning, msg);
+			return;
+		}
+		G4ChRPhysicsTableService::SetNoOfRIndexGridNodes(newValue);
+		if ((*p_ChRProcess->m_registeredModels.begin())->GetVerboseLevel() > 0)
+			std::cout << "The noOfRIndexGridNodes value has been changed! Now deleting old physics tables...\n";
+		RebuildBaseChRPhysicsTables();
+	}
 	else if (uiCmd == p_printPhysicsVector) {
 		std::string printLevel, materialName;
 		// aStr returns a space (' ') character for nothing??
 		if (aStr == G4String{ ' ' }) {
-			G4BaseChR_Model::PrintChRPhysDataVec();
+			G4ChRPhysicsTableService::PrintChRPhysDataVec();
 			return;
 		}
 		std::string::iterator spaceChar = std::find(aStr.begin(), aStr.end(), ' ');
@@ -254,11 +422,64 @@ void G4CherenkovProcess_Messenger::SetNewValue(G4UIcommand* uiCmd, G4String aStr
 				G4Exception("G4CherenkovProcess_Messenger::SetNewValue", "WE_ChRMessenger05", JustWarning, err);
 				return;
 			}
-			G4BaseChR_Model::PrintChRPhysDataVec(printLevelNumber, aMaterial);
+			G4ChRPhysicsTableService::PrintChRPhysDataVec(printLevelNumber, aMaterial);
+			return;
+		}
+		G4ChRPhysicsTableService::PrintChRPhysDataVec(printLevelNumber);
+	}
+	else if (uiCmd == p_validatePhysicsTables) {
+		G4ChRPhysicsTableService::ValidatePhysicsTables();
+	}
+	else if (uiCmd == p_usePhotonPool) {
+		// executed on each thread (broadcast), i.e., for the photon pool of that thread
+		const G4int pageFactor = p_usePhotonPool->ConvertToInt(aStr);
+		if (pageFactor == 0)
+			G4ChRPhotonPool::Disable();
+		else
+			G4ChRPhotonPool::Enable(static_cast<unsigned int>(pageFactor), (*p_ChRProcess->m_registeredModels.begin())->GetVerboseLevel());
+	}
+	else if (uiCmd == p_forceEmissionTo) {
+		std::istringstream iss{ aStr };
+		size_t modelID;
+		std::string targetName;
+		G4double outsideRIndex = 1.;
+		iss >> modelID >> targetName >> outsideRIndex;
+		if (modelID >= p_ChRProcess->m_registeredModels.size()) {
+			std::ostringstream err;
+			err << "A Cherenkov model with ID: " << modelID << " is not registered! Forced emission has not been changed.\n";
+			G4Exception("G4CherenkovProcess_Messenger::SetNewValue", "WE_ChRMessenger12", JustWarning, err);
 			return;
 		}
-		G4BaseChR_Model::PrintChRPhysDataVec(printLevelNumber);
+		if (targetName == "none")
+			p_ChRProcess->m_registeredModels[modelID]->DisableForcedEmission();
+		else
+			p_ChRProcess->m_registeredModels[modelID]->SetForcedEmission(targetName, outsideRIndex);
+	}
+	else if (uiCmd == p_useCounterBasedRNG) {
+		std::istringstream iss{ aStr };
+		std::string useCounterBased;
+		G4long seed = 0;
+		iss >> useCounterBased >> seed;
+		if (G4UIcommand::ConvertToBool(useCounterBased.c_str()))
+			G4ChRRandomBuffer::EnableCounterBasedMode(seed);
+		else
+			G4ChRRandomBuffer::DisableCounterBasedMode();
 	}
 	else //just in case of some bug, but it can be removed
 		G4Exception("G4CherenkovProcess_Messenger::SetNewValue", "WE_ChRMessenger06", JustWarning, "Command not found!\n");
+}
+
+//=========private G4CherenkovProcess_Messenger:: methods=========
+
+void G4CherenkovProcess_Messenger::RebuildBaseChRPhysicsTables() const {
+	G4ChRPhysicsTableService::ClearPhysicsTables();
+	if ((*p_ChRProcess->m_registeredModels.begin())->GetVerboseLevel() > 0)
+		std::cout << "Old physics tables have been removed! Now creating new physics tables...\n";
+	auto* particleIterator = G4ParticleTable::GetParticleTable()->GetIterator();
+	particleIterator->reset();
+	while ((*particleIterator)()) { //a useless and bad loop for this process, but still... pre-run time
+		(*p_ChRProcess->m_registeredModels.begin())->BuildModelPhysicsTable(*(particleIterator->value()));
+	}
+	if ((*p_ChRProcess->m_registeredModels.begin())->GetVerboseLevel() > 0)
+		std::cout << "Physics tables have been successfully rebuilt!\n";
 }
\ No newline at end of file
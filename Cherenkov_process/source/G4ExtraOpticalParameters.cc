@@ -17,6 +17,8 @@
 #include "G4CherenkovProcess.hh"
 #include "G4SystemOfUnits.hh"
 
+std::atomic<std::uint64_t> G4ExtraOpticalParameters::m_ChRMatDataGeneration{ 1 };
+
 //=========public G4ExtraOpticalParameters:: methods=========
 
 std::shared_ptr<G4ExtraOpticalParameters> G4ExtraOpticalParameters::GetInstance() {
@@ -57,6 +59,7 @@ void G4ExtraOpticalParameters::ScanAndAddUnregisteredLV() {
 			}
 		}
 	}
+	IncrementChRMatDataGeneration();
 }
 
 #define PrintTrueOrFalse(memberName)	\
@@ -97,6 +100,11 @@ void G4ExtraOpticalParameters::PrintChRMatData(const G4LogicalVolume* aLogicalVo
 			std::cout << (*aMatData.p_middlePoint)[0] << ", " << (*aMatData.p_middlePoint)[1] << ", " << (*aMatData.p_middlePoint)[2] << "\n";
 		else
 			std::cout << "Not defined\n";
+		std::cout << std::setw(31) << "Thinning factor:";
+		if (aMatData.m_thinningFactor == 0)
+			std::cout << "global (" << G4ExtraOpticalParameters::GetInstance()->GetThinningFactor() << ")\n";
+		else
+			std::cout << aMatData.m_thinningFactor << '\n';
 	};
 	std::cout.fill('=');
 	std::cout << std::defaultfloat << std::setw(51) << '\n'
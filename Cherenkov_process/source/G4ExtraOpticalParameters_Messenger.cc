@@ -17,12 +17,13 @@
 #include "G4LogicalVolumeStore.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
-#include "G4BaseChR_Model.hh"
+#include "G4ChRPhysicsTableService.hh"
 #include "G4Material.hh"
 #include "G4CherenkovProcess.hh"
 #include "G4ProcessTable.hh"
 //std:: headers
 #include <functional>
+#include <sstream>
 
 //=========public G4ExtraOpticalParameters_Messenger:: methods=========
 
@@ -71,6 +72,20 @@ G4ExtraOpticalParameters_Messenger::G4ExtraOpticalParameters_Messenger(G4ExtraOp
 	p_printChRMatData->SetParameter(uiParameter);
 	p_printChRMatData->SetToBeBroadcasted(false);
 	p_printChRMatData->AvailableForStates(G4State_Idle);
+
+	p_thinningFactor = new G4UIcommand{ "/process/optical/G4ChRProcess/extraOptParams/thinningFactor", this };
+	p_thinningFactor->SetGuidance("Use this command to set the thinning factor k of Cherenkov photons. With k > 1, on average");
+	p_thinningFactor->SetGuidance("k times fewer photons are emitted and each of them has the weight k (G4Track::GetWeight).");
+	p_thinningFactor->SetGuidance("If a logical volume is not specified, the global value is set (it's used for all logical volumes");
+	p_thinningFactor->SetGuidance("with the factor 0). The value 1 turns thinning off.");
+	uiParameter = new G4UIparameter{ "factor", 'i', false };
+	uiParameter->SetParameterRange("factor>=0 && factor<=65535");
+	p_thinningFactor->SetParameter(uiParameter);
+	uiParameter = new G4UIparameter{ "LV_name", 's', true };
+	uiParameter->SetDefaultValue("");
+	p_thinningFactor->SetParameter(uiParameter);
+	p_thinningFactor->SetToBeBroadcasted(false);
+	p_thinningFactor->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 
 G4ExtraOpticalParameters_Messenger::~G4ExtraOpticalParameters_Messenger() {
@@ -79,6 +94,7 @@ G4ExtraOpticalParameters_Messenger::~G4ExtraOpticalParameters_Messenger() {
 	delete p_executeModel;
 	delete p_exoticRIndex;
 	delete p_printChRMatData;
+	delete p_thinningFactor;
 }
 
 void G4ExtraOpticalParameters_Messenger::SetNewValue(G4UIcommand* uiCmd, G4String aStr) {
@@ -111,6 +127,7 @@ void G4ExtraOpticalParameters_Messenger::SetNewValue(G4UIcommand* uiCmd, G4Strin
 		}
 		G4CherenkovMatData& lvMatData = p_extraOpticalParameters->FindOrCreateChRMatData(aLogicVolume);
 		lvMatData.m_executeModel = std::stoull(name2.c_str());
+		G4ExtraOpticalParameters::IncrementChRMatDataGeneration();
 	}
 	else if (uiCmd == p_exoticRIndex) {
 		findLV();
@@ -128,6 +145,7 @@ void G4ExtraOpticalParameters_Messenger::SetNewValue(G4UIcommand* uiCmd, G4Strin
 		if (newValue == lvMatData.m_exoticRIndex)
 			return;
 		lvMatData.m_exoticRIndex = newValue;
+		G4ExtraOpticalParameters::IncrementChRMatDataGeneration();
 		// now, find if there's another LV with the same material. If there is, check its m_exoticRIndex flag.
 		// If exotic RIndex is not used anymore, remove unnecessary physics-table data and free up some memory
 		// If it is in use, do nothing
@@ -140,14 +158,14 @@ void G4ExtraOpticalParameters_Messenger::SetNewValue(G4UIcommand* uiCmd, G4Strin
 				return; // the other LV with the given material keeps physics table, no matter what
 		}
 		if (newValue) {
-			if (!G4BaseChR_Model::AddExoticRIndexPhysicsTable(aMaterial->GetIndex(), true)) {
+			if (!G4ChRPhysicsTableService::AddExoticRIndexPhysicsTable(aMaterial->GetIndex(), true)) {
 				lvMatData.m_exoticRIndex = false;
 				const char* err = "m_exoticRIndex flag did not successfully change to true!\nThe material's RIndex is not suitable for the 'true' m_exoticRIndex flag condition!\n";
 				G4Exception("G4ExtraOpticalParameters_Messenger::SetNewValue", "WE_EOPMessenger04", JustWarning, err);
 			}
 		}
 		else
-			G4BaseChR_Model::RemoveExoticRIndexPhysicsTable(aMaterial->GetIndex());
+			G4ChRPhysicsTableService::RemoveExoticRIndexPhysicsTable(aMaterial->GetIndex());
 	}
 	else if (uiCmd == p_printChRMatData) {
 		if (!aStr.empty()) {
@@ -163,6 +181,31 @@ void G4ExtraOpticalParameters_Messenger::SetNewValue(G4UIcommand* uiCmd, G4Strin
 		}
 		p_extraOpticalParameters->PrintChRMatData();
 	}
+	else if (uiCmd == p_thinningFactor) {
+		std::istringstream iStr{ aStr };
+		unsigned short newValue = 0;
+		std::string lvName;
+		iStr >> newValue >> lvName;
+		if (lvName.empty()) {
+			if (newValue == 0) {
+				const char* err = "The global thinning factor must be greater than 0! The command is ignored!\n";
+				G4Exception("G4ExtraOpticalParameters_Messenger::SetNewValue", "WE_EOPMessenger07", JustWarning, err);
+				return;
+			}
+			p_extraOpticalParameters->SetThinningFactor(newValue);
+			return;
+		}
+		G4LogicalVolume* aLogicVolume = G4LogicalVolumeStore::GetInstance()->GetVolume(lvName);
+		if (!aLogicVolume) {
+			std::ostringstream err;
+			err << "You wrote that the name of a logical volume is: " << std::quoted(lvName)
+				<< "\nwhile there's no such a registered volume. Please, check the names again!\n";
+			G4Exception("G4ExtraOpticalParameters_Messenger::SetNewValue", "WE_EOPMessenger08", JustWarning, err);
+			return;
+		}
+		p_extraOpticalParameters->FindOrCreateChRMatData(aLogicVolume).m_thinningFactor = newValue;
+		G4ExtraOpticalParameters::IncrementChRMatDataGeneration();
+	}
 	else { //just in case of some bug, but it can be removed
 		G4Exception("G4ExtraOpticalParameters_Messenger::SetNewValue", "WE_EOPMessenger06", JustWarning, "Command not found!\n");
 	}
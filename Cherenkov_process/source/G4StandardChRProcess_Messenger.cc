@@ -195,15 +195,15 @@ void G4StandardChRProcess_Messenger::SetNewValue(G4UIcommand* uiCmd, G4String aS
 	}
 	else if (uiCmd == p_noOfBetaSteps) {
 		const unsigned int newBetaStep = std::stoul(aStr);
-		if (newBetaStep == p_standardChRProcess->GetNoOfBetaSteps()) {
+		if (newBetaStep == G4ChRPhysicsTableService::GetNoOfBetaSteps()) {
 			const char* msg = "betaStep of Cherenkov models has not been changed - you used the same number that's already set!\n";
 			G4Exception("G4StandardChRProcess_Messenger::SetNewValue", "WE_stdChRMessenger04", JustWarning, msg);
 			return;
 		}
-		p_standardChRProcess->SetNoOfBetaSteps(newBetaStep);
+		G4ChRPhysicsTableService::SetNoOfBetaSteps(newBetaStep);
 		if (p_standardChRProcess->verboseLevel > 0)
 			std::cout << "All betaStep values have been changed! Now deleting old physics tables...\n";
-		p_standardChRProcess->m_ChRPhysDataVec.clear();
+		G4ChRPhysicsTableService::ClearPhysicsTables();
 		if (p_standardChRProcess->verboseLevel > 0)
 			std::cout << "Old physics tables have been removed! Now creating new physics tables...\n";
 		auto* particleIterator = G4ParticleTable::GetParticleTable()->GetIterator();
@@ -221,7 +221,7 @@ void G4StandardChRProcess_Messenger::SetNewValue(G4UIcommand* uiCmd, G4String aS
 		std::string printLevel, materialName;
 		// aStr returns a space (' ') character for nothing??
 		if (aStr == G4String{ ' ' }) {
-			p_standardChRProcess->PrintChRPhysDataVec();
+			G4ChRPhysicsTableService::PrintChRPhysDataVec();
 			return;
 		}
 		std::string::iterator spaceChar = std::find(aStr.begin(), aStr.end(), ' ');
@@ -238,10 +238,10 @@ void G4StandardChRProcess_Messenger::SetNewValue(G4UIcommand* uiCmd, G4String aS
 				G4Exception("G4StandardChRProcess_Messenger::SetNewValue", "WE_stdChRMessenger05", JustWarning, err);
 				return;
 			}
-			p_standardChRProcess->PrintChRPhysDataVec(printLevelNumber, aMaterial);
+			G4ChRPhysicsTableService::PrintChRPhysDataVec(printLevelNumber, aMaterial);
 			return;
 		}
-		p_standardChRProcess->PrintChRPhysDataVec(printLevelNumber);
+		G4ChRPhysicsTableService::PrintChRPhysDataVec(printLevelNumber);
 	}
 	else if (uiCmd == p_exoticRIndex) {
 		std::string matName, newFlag;
@@ -257,16 +257,12 @@ void G4StandardChRProcess_Messenger::SetNewValue(G4UIcommand* uiCmd, G4String aS
 			G4Exception("G4ExtraOpticalParameters_Messenger::SetNewValue", "WE_stdChRMessenger06", JustWarning, err);
 			return;
 		}
-		G4bool tableExists;
-		if (p_standardChRProcess->m_ChRPhysDataVec[aMaterial->GetIndex()].m_aroundBetaValues.front().p_valuesCDF)
-			tableExists = true;
-		else
-			tableExists = false;
+		G4bool tableExists = (*G4ChRPhysicsTableService::GetChRPhysDataVec())[aMaterial->GetIndex()].HasCDFTables();
 		G4bool newValue = p_exoticRIndex->ConvertToBool(newFlag.c_str());
 		if (newValue == tableExists)
 			return;
 		if (newValue) {
-			if (!p_standardChRProcess->AddExoticRIndexPhysicsTable(aMaterial->GetIndex(), true)) {
+			if (!G4ChRPhysicsTableService::AddExoticRIndexPhysicsTable(aMaterial->GetIndex(), true)) {
 				std::ostringstream err;
 				err << "Exotic RIndex tables are not built for material " << std::quoted(matName)
 					<< "\nThe material's RIndex is not suitable for exotic RIndex tables!\n";
@@ -274,7 +270,7 @@ void G4StandardChRProcess_Messenger::SetNewValue(G4UIcommand* uiCmd, G4String aS
 			}
 		}
 		else
-			p_standardChRProcess->RemoveExoticRIndexPhysicsTable(aMaterial->GetIndex());
+			G4ChRPhysicsTableService::RemoveExoticRIndexPhysicsTable(aMaterial->GetIndex());
 	}
 	else { //just in case of some bug, but it can be removed
 		G4Exception("G4StandardChRProcess_Messenger::SetNewValue", "WE_stdChRMessenger08", JustWarning, "Command not found!\n");
@@ -9,7 +9,7 @@
 //G4 headers
 #include "G4ThinTargetChR_Model.hh"
 #include "G4ParticleChange.hh"
-#include "G4Poisson.hh"
+#include "G4ChRPhotonPool.hh"
 #include "G4OpticalPhoton.hh"
 #include "G4ExtraOpticalParameters.hh"
 #include "G4SystemOfUnits.hh"
@@ -29,6 +29,8 @@ using dimBufferIter_t = std::vector<G4ThreeVector>::iterator;
 	const unsigned char passNo, std::array<size_t, 3>& dimensionNoOfLayers);
 static void PrintJustWarningExplanations(const size_t id, const void* aType1 = nullptr, const void* aType2 = nullptr);
 static void PrintSuccessInfo(const G4LogicalVolume* aLogic, const G4CherenkovMatData& matData, std::array<size_t, 3>* noLayersPerDimension = nullptr);
+// target cones of forced emission (and the global cone) are widened by 5 sigma of smearing, so the neglected tails are below 1.e-6
+static constexpr G4double o_noOfMarginSigmas = 5.;
 
 //=========public G4ThinTargetChR_Model:: methods=========
 
@@ -37,16 +39,14 @@ G4ThinTargetChR_Model::G4ThinTargetChR_Model(const char* theName)
 	m_includeFiniteThickness = true;
 }
 
-G4VParticleChange* G4ThinTargetChR_Model::PostStepModelDoIt(const G4Track& aTrack, const G4Step& aStep, const G4CherenkovMatData& aChRMatData) {
+G4VParticleChange* G4ThinTargetChR_Model::PostStepModelDoIt(const G4Track& aTrack, const G4Step& aStep, const G4ChRResolvedOptics& theOptics) {
 	p_particleChange->Initialize(aTrack);
 
 	const G4DynamicParticle* aParticle = aTrack.GetDynamicParticle();
-	const G4Material* aMaterial = aTrack.GetMaterial();
-	size_t materialID = aMaterial->GetIndex();
 
 	// No need for various checking, bcs the PostStepIntLNG
 	// would kill it already if something was off
-	if (aChRMatData.m_minAxis > 2) {
+	if (theOptics.m_minAxis > 2) {
 		const char* err = "Currently, G4ThinTargetChR_Model can be used only for G4Tubs and G4Box\n"
 			"volumes and only the thickness (a single dimension) should be\n"
 			"small (e.g., '1 mm' and less). If you want to produce Cherenkov\n"
@@ -63,7 +63,6 @@ G4VParticleChange* G4ThinTargetChR_Model::PostStepModelDoIt(const G4Track& aTrac
 
 	const G4ThreeVector x0 = preStepPoint->GetPosition();
 	const G4ThreeVector p0 = aStep.GetDeltaPosition().unit();
-	const G4double t0 = preStepPoint->GetGlobalTime();
 
 	const G4VTouchable* aTouchable = aTrack.GetTouchable();
 	// Moving to local coordinate system to easily find all points.
@@ -74,126 +73,84 @@ G4VParticleChange* G4ThinTargetChR_Model::PostStepModelDoIt(const G4Track& aTrac
 	G4ThreeVector prePositionInLocal{ x0 };
 	inverseTransform.ApplyPointTransform(prePositionInLocal);
 	G4ThreeVector aLocalMiddlePoint{ 0., 0., 0. };
-	if (aChRMatData.p_middlePoint) {
-		aLocalMiddlePoint = *aChRMatData.p_middlePoint;
+	if (theOptics.p_middlePoint) {
+		aLocalMiddlePoint = *theOptics.p_middlePoint;
 		inverseTransform.ApplyPointTransform(aLocalMiddlePoint);
 	}
 	
 	G4ThreeVector localEntryPoint, localExitPoint; // extended x0 and p0 to find entry and exit points in local
-	if (!FindParticleEntryAndExitPoints(localEntryPoint, localExitPoint, aLocalMiddlePoint, directionInLocal, prePositionInLocal, aChRMatData))
+	if (!FindParticleEntryAndExitPoints(localEntryPoint, localExitPoint, aLocalMiddlePoint, directionInLocal, prePositionInLocal, theOptics))
 		return p_particleChange;
 
-	G4PhysicsFreeVector* RIndex = aMaterial->GetMaterialPropertiesTable()->GetProperty(kRINDEX);
-	if (!RIndex)
-		RIndex = aMaterial->GetMaterialPropertiesTable()->GetProperty(kREALRINDEX);
+	const G4ChRPhysTableData& physData = *theOptics.p_physData;
 
 	const G4double charge = aParticle->GetDefinition()->GetPDGCharge();
 	const G4double beta = (preStepPoint->GetBeta() + postStepPoint->GetBeta()) * 0.5;
 
-	G4double meanNumberOfPhotons = CalculateAverageNumberOfPhotons(charge, beta, materialID);
+	G4double meanNumberOfPhotons = CalculateAverageNumberOfPhotons(charge, beta, physData);
 
 	if (meanNumberOfPhotons <= 0.0) {
 		//unchanged particle; number of secondaries is 0 anyway after p_particleChange->Initialize(aTrack);
 		return p_particleChange;
 	}
 
-	meanNumberOfPhotons = meanNumberOfPhotons * aStep.GetStepLength();
-	G4int noOfPhotons = (G4int)G4Poisson(meanNumberOfPhotons);
+	// with thinning, k times fewer photons with the weight k (see G4ExtraOpticalParameters.hh)
+	meanNumberOfPhotons = meanNumberOfPhotons * aStep.GetStepLength() / theOptics.m_thinningFactor;
+	// the first number of the step (counter-based numbers depend only on the step, see G4ChRRandomBuffer.hh)
+	m_photonBatch.m_randomBuffer.BeginStep(aTrack);
+	G4int noOfPhotons = (G4int)m_photonBatch.m_randomBuffer.Poisson(meanNumberOfPhotons);
 
-	G4OpticalParameters* optParameters = G4OpticalParameters::Instance();
-	//got no idea what's the point of 'optParameters->GetCerenkovStackPhotons()', but staying consistent with G4Cerenkov
-	if (noOfPhotons <= 0 || !optParameters->GetCerenkovStackPhotons())
+	//got no idea what's the point of 'GetCerenkovStackPhotons()', but staying consistent with G4Cerenkov
+	if (noOfPhotons <= 0 || !theOptics.m_stackPhotons)
 		return p_particleChange;
 
-	p_particleChange->SetNumberOfSecondaries(noOfPhotons);
+	G4ChRPhotonPool::SetNumberOfSecondaries(p_particleChange, noOfPhotons);
 
-	if (optParameters->GetCerenkovTrackSecondariesFirst())
+	if (theOptics.m_trackSecondariesFirst)
 		if (aTrack.GetTrackStatus() == fAlive)
 			p_particleChange->ProposeTrackStatus(fSuspend);
 
-	G4double lossEnergy = 0.;
-
-	// initializing to keep the compiler silent
-	G4double minEnergy = 0.;
-	G4double maxEnergy = 0.;
-	// or would it be better to keep it in stack and check condition *1* every time in the following 'for'??
-	std::vector<std::pair<G4double, G4double>>* bigBetaCDFVector = nullptr;
-	if (aChRMatData.m_exoticRIndex) {
-		if (beta > m_ChRPhysDataVec[materialID].m_aroundBetaValues.back().m_betaValue) { // *1*
-			bigBetaCDFVector = new std::vector<std::pair<G4double, G4double>>{};
-			std::vector<G4ThreeVector>* bigBetaVec = m_ChRPhysDataVec[materialID].p_bigBetaCDFVector;
-			bigBetaCDFVector->reserve(bigBetaVec->size());
-			G4double maxValueForBigBeta = bigBetaVec->back().getY() - bigBetaVec->back().getZ() / (beta * beta);
-			for (auto i = bigBetaVec->begin(); i != bigBetaVec->end() - 1; i++)
-				bigBetaCDFVector->emplace_back((*i).getX(), ((*i).getY() - (*i).getZ() / (beta * beta)) / maxValueForBigBeta);
-			bigBetaCDFVector->emplace_back(bigBetaVec->back().getX(), 1.);
-		}
-		else {
-			const std::vector<G4ChRPhysTableData::G4AroundBetaBasedValues>& physDataVec = m_ChRPhysDataVec[materialID].m_aroundBetaValues;
-			// Returning the higher beta value from tables. With reasonable number of beta steps, some negligible
-			// inaccuracies can be expected in the distribution, while I can save some number of processor cycles
-			bigBetaCDFVector = physDataVec[static_cast<size_t>(std::lower_bound(physDataVec.begin() + 1, physDataVec.end(), beta,
-				[](const G4ChRPhysTableData::G4AroundBetaBasedValues& value1, const G4double value2) {return value1.m_betaValue < value2; }) - physDataVec.begin())].p_valuesCDF;
-		}
-	}
-	else {
-		minEnergy = RIndex->Energy(0);
-		maxEnergy = RIndex->GetMaxEnergy();
-	}
-
 	G4double theCosAngle;
-	if (aChRMatData.m_minAxis == 0)
+	if (theOptics.m_minAxis == 0)
 		theCosAngle = std::abs(directionInLocal.dot({ 1., 0., 0. }));
-	else if (aChRMatData.m_minAxis == 1)
+	else if (theOptics.m_minAxis == 1)
 		theCosAngle = std::abs(directionInLocal.dot({ 0., 1., 0. }));
-	else /*aChRMatData.m_minAxis == 2*/
+	else /*theOptics.m_minAxis == 2*/
 		theCosAngle = std::abs(directionInLocal.dot({ 0., 0., 1. }));
 
-	/*if (bigBetaCDFVector) {
-		std::ofstream oVEC;
-		std::string fileName = "CDF - ";
-		fileName += std::to_string(aTrack.GetKineticEnergy() / MeV) + " - " + std::to_string(beta) + ".csv";
-		oVEC.open(fileName, std::ios::out | std::ios::trunc);
-		for (const auto& i : *bigBetaCDFVector)
-			oVEC << i.first / eV << ',' << i.second << '\n';
-		oVEC.close();
-	}*/
-	for (G4int i = 0; i < noOfPhotons; ++i) {
-		G4double rand;
-		G4double sampledEnergy, sampledRI;
-		G4double cosTheta, sin2Theta;
-		// sample an energy
-		if (aChRMatData.m_exoticRIndex) {
-			do {
-				rand = G4UniformRand();
-				size_t lowLoc = static_cast<size_t>(std::lower_bound(bigBetaCDFVector->begin() + 1, bigBetaCDFVector->end(), rand,
-					[](const std::pair<G4double, G4double>& value1, const G4double value2) {return value1.second < value2; }) - bigBetaCDFVector->begin());
-				sampledEnergy = G4LinearInterpolate2D_GetX((*bigBetaCDFVector)[lowLoc].second, (*bigBetaCDFVector)[lowLoc - 1].second,
-					(*bigBetaCDFVector)[lowLoc].first, (*bigBetaCDFVector)[lowLoc - 1].first, rand);
-				sampledRI = RIndex->Value(sampledEnergy);
-				cosTheta = 1. / (sampledRI * beta); //might give > 1. for strange n(E) functions
-				sin2Theta = (1.0 - cosTheta) * (1.0 + cosTheta);
-			} while (sin2Theta <= 0.);
+	// stage 1 - sampling of all photons
+	G4ChREnergySampler aSampler = PrepareEnergySampler(beta, theOptics);
+	m_photonBatch.Generate(aSampler, static_cast<size_t>(noOfPhotons));
+	const G4ChRRotationFrame primaryFrame = G4ChRRotationFrame::FromDirection(p0);
+	// phi must be biased before smearing, as gaussSigma depends on it (see G4ChRAngularBiasing.hh)
+	const G4bool useForcedEmission = FindTargetCones(aStep, theOptics);
+	if (useForcedEmission) {
+		// cones are widened by o_noOfMarginSigmas sigma of smearing towards their axes (see G4ChRForcedEmission.hh)
+		for (size_t i = 0; i < m_photonBatch.m_noOfPhotons; ++i) {
+			const G4ThreeVector localAxis =
+				inverseTransform.TransformAxis({ m_photonBatch.m_coneAxisX[i], m_photonBatch.m_coneAxisY[i], m_photonBatch.m_coneAxisZ[i] });
+			m_photonBatch.m_coneMargin[i] = CalculateConeMargin(localEntryPoint, localExitPoint, localAxis, i, theCosAngle, theOptics);
 		}
-		else {
-			while (true) {
-				rand = G4UniformRand();
-				sampledEnergy = minEnergy + rand * (maxEnergy - minEnergy);
-				sampledRI = RIndex->Value(sampledEnergy);
-				cosTheta = 1. / (sampledRI * beta); //might give > 1. for strange n(E) functions
-				sin2Theta = (1.0 - cosTheta) * (1.0 + cosTheta);
-				if (sin2Theta <= 0.) {
-					//the following 'if' is to prevent bad distribution if the user modified an almost non-exotic RIndex
-					if (!aChRMatData.m_exoticFlagInital)
-						minEnergy = sampledEnergy;
-					continue;
-				}
-				break;
-			}
+		m_photonBatch.BiasPhiToTargetCones(primaryFrame);
+	}
+	else if (m_useAngularBiasing) {
+		// the same for the global cone (see G4ChRAngularBiasing.hh); the phi window is not affected by smearing
+		const G4bool usesGlobalCone = m_angularBiasing.UsesGlobalCone();
+		if (usesGlobalCone) {
+			const G4ThreeVector localAxis = inverseTransform.TransformAxis(m_angularBiasing.m_coneAxis);
+			for (size_t i = 0; i < m_photonBatch.m_noOfPhotons; ++i)
+				m_photonBatch.m_coneMargin[i] = CalculateConeMargin(localEntryPoint, localExitPoint, localAxis, i, theCosAngle, theOptics);
 		}
+		m_photonBatch.BiasPhi(m_angularBiasing, primaryFrame, usesGlobalCone);
+	}
+
+	// the thin-target stage - smearing of theta; gaussSigma depends on the angle of emission (phi),
+	// that's if the radiator is rotated relative to the charged particle
+	// Momenta are needed in local - a single frame instead of rotateUz(p0) to global and then ApplyAxisTransform to local
+	m_photonBatch.BuildDirections(primaryFrame.Transformed(inverseTransform), false);
+	for (size_t i = 0; i < m_photonBatch.m_noOfPhotons; ++i) {
 		//h * c = 1.239841984e-6 * m * eV
-		G4double waveLng = 1.239841984e-6 * m * eV / sampledEnergy;
-		G4double sinTheta = std::sqrt(sin2Theta);
+		G4double waveLng = 1.239841984e-6 * m * eV / m_photonBatch.m_energy[i];
 
 		/*
 		the following gaussSigma is from the previous versions (0.5 and earlier)
@@ -204,61 +161,25 @@ G4VParticleChange* G4ThinTargetChR_Model::PostStepModelDoIt(const G4Track& aTrac
 		//The following equation is another possibility to express the Gauss sigma - another theory, but should be yet considered
 		/*G4double gaussSigma = 1.18 * waveLng * beta * std::cos(psi) * (1 + beta * std::sin(thetaChR) * std::sin(psi))
 			/ (CLHEP::pi * matThickness * (beta * std::sin(thetaChR) + std::sin(psi)));*/
-		G4double thetaChR = std::acos(cosTheta);
-		
-		// first obtain phi because gaussSigma depends on the angle of emission, that's if
-		// the radiator is rotated relative to the charged particle
-		rand = G4UniformRand();
-		G4double phi = CLHEP::twopi * rand;
-		G4double sinPhi = std::sin(phi);
-		G4double cosPhi = std::cos(phi);
 
-		G4ThreeVector photonMomentum{ sinTheta * cosPhi, sinTheta * sinPhi, cosTheta };
-		// Now to global - just a quick solution and might change in the future to have a single transform matrix (this is a waste of processor cycles)
-		photonMomentum.rotateUz(p0);
-		// And then to local
-		inverseTransform.ApplyAxisTransform(photonMomentum);
-		
-		if (G4double neededDistance = CalculateGaussSigmaDistance(localEntryPoint, localExitPoint, photonMomentum, aChRMatData);
+		const G4ThreeVector photonMomentum{ m_photonBatch.m_momentumX[i], m_photonBatch.m_momentumY[i], m_photonBatch.m_momentumZ[i] };
+
+		if (G4double neededDistance = CalculateGaussSigmaDistance(localEntryPoint, localExitPoint, photonMomentum, theOptics);
 			neededDistance != DBL_MAX) {
-			G4double gaussSigma = 0.42466 * waveLng * theCosAngle / (sampledRI * neededDistance);
-			thetaChR = G4RandGauss::shoot(thetaChR, gaussSigma);
-			cosTheta = std::cos(thetaChR);
-			sinTheta = std::sin(thetaChR);
+			G4double gaussSigma = 0.42466 * waveLng * theCosAngle / (m_photonBatch.m_RIndex[i] * neededDistance);
+			m_photonBatch.SelectPhotonStream(i);
+			G4double thetaChR = m_photonBatch.m_randomBuffer.Gauss(std::acos(m_photonBatch.m_cosTheta[i]), gaussSigma);
+			m_photonBatch.m_cosTheta[i] = std::cos(thetaChR);
+			m_photonBatch.m_sinTheta[i] = std::sin(thetaChR);
 		}
+	}
 
-		photonMomentum.set(sinTheta * cosPhi, sinTheta * sinPhi, cosTheta);
-
-		// Rotate momentum direction back to global reference system
-		photonMomentum.rotateUz(p0);
-
-		// Determine polarization of new photon
-		G4ThreeVector photonPolarization{ cosTheta * cosPhi, cosTheta * sinPhi, -sinTheta };
-
-		// Rotate back to original coordinate system
-		photonPolarization.rotateUz(p0);
-		// Generate a new photon:
-		auto aCerenkovPhoton = new G4DynamicParticle{ G4OpticalPhoton::OpticalPhoton(), photonMomentum };
-
-		aCerenkovPhoton->SetPolarization(photonPolarization);
-		aCerenkovPhoton->SetKineticEnergy(sampledEnergy);
-		lossEnergy += sampledEnergy;
-
-		rand = G4UniformRand();
-
-		G4double delta = rand * aStep.GetStepLength();
-		G4double deltaTime = delta / (preStepPoint->GetVelocity() + rand * (postStepPoint->GetVelocity() - preStepPoint->GetVelocity()) * 0.5);
-
-		G4double aSecondaryTime = t0 + deltaTime;
-		G4ThreeVector aSecondaryPosition{ x0 + rand * aStep.GetDeltaPosition() };
-
-		// Generate new G4Track object:
-		G4Track* aSecondaryTrack = new G4Track{ aCerenkovPhoton, aSecondaryTime, aSecondaryPosition };
+	// smeared photons outside the acceptance window (or the target cones) are not created
+	if (useForcedEmission || m_useAngularBiasing)
+		m_photonBatch.ApplyAcceptance(GetAngularBiasing(), primaryFrame);
 
-		aSecondaryTrack->SetTouchableHandle(aStep.GetPreStepPoint()->GetTouchableHandle());
-		aSecondaryTrack->SetParentID(aTrack.GetTrackID());
-		p_particleChange->AddSecondary(aSecondaryTrack);
-	}
+	// stage 2 - G4Track objects
+	const G4double lossEnergy = m_photonBatch.MaterializePhotons(aTrack, aStep, p_particleChange, theOptics.m_thinningFactor);
 
 	if (m_useModelWithEnergyLoss) {
 		//considering only energy loss, but neglecting change in momentum direction...
@@ -271,9 +192,6 @@ G4VParticleChange* G4ThinTargetChR_Model::PostStepModelDoIt(const G4Track& aTrac
 		std::cout << "\n Exiting from G4ThinTargetChR_Model::PostStepModelDoIt -- NumberOfSecondaries = "
 		<< p_particleChange->GetNumberOfSecondaries() << G4endl;
 
-	if (bigBetaCDFVector && beta > m_ChRPhysDataVec[materialID].m_aroundBetaValues.back().m_betaValue)
-		delete bigBetaCDFVector;
-
 	return p_particleChange;
 }
 
@@ -675,6 +593,8 @@ void G4ThinTargetChR_Model::BuildModelPhysicsTable(const G4ParticleDefinition& a
 			}
 		}
 	}
+	// G4CherenkovProcess must resolve the thin-target geometry again
+	G4ExtraOpticalParameters::IncrementChRMatDataGeneration();
 }
 
 //=========private G4ThinTargetChR_ModelMessenger:: methods=========
@@ -684,63 +604,63 @@ G4bool G4ThinTargetChR_Model::FindParticleEntryAndExitPoints(
 		const G4ThreeVector& localMiddlePoint,
 		const G4ThreeVector& localDirection,
 		const G4ThreeVector& localPrePoint,
-		const G4CherenkovMatData& aChRMatData) const {
+		const G4ChRResolvedOptics& theOptics) const {
 
 	// newPoint = oldPoint + intensity * unitVector
 	G4double intensity;
 	// keeping calculations relative to the localEntryPoint, not to the emission point of photons
 	// that should be still considered... it would cause some problems
-	if (aChRMatData.m_minAxis == 0) {
+	if (theOptics.m_minAxis == 0) {
 		if (localDirection.getX() == 0.) {
 			if (m_verboseLevel > 0)
 				PrintJustWarningExplanations(11);
 			return false;
 		}
-		intensity = (-aChRMatData.m_halfThickness + localMiddlePoint.getX() - localPrePoint.getX()) / localDirection.getX();
-		localEntryPoint.set(-aChRMatData.m_halfThickness + localMiddlePoint.getX(),
+		intensity = (-theOptics.m_halfThickness + localMiddlePoint.getX() - localPrePoint.getX()) / localDirection.getX();
+		localEntryPoint.set(-theOptics.m_halfThickness + localMiddlePoint.getX(),
 			localPrePoint.getY() + intensity * localDirection.getY(),
 			localPrePoint.getZ() + intensity * localDirection.getZ());
-		intensity = (aChRMatData.m_halfThickness + localMiddlePoint.getX() - localPrePoint.getX()) / localDirection.getX();
-		localExitPoint.set(aChRMatData.m_halfThickness + localMiddlePoint.getX(),
+		intensity = (theOptics.m_halfThickness + localMiddlePoint.getX() - localPrePoint.getX()) / localDirection.getX();
+		localExitPoint.set(theOptics.m_halfThickness + localMiddlePoint.getX(),
 			localPrePoint.getY() + intensity * localDirection.getY(),
 			localPrePoint.getZ() + intensity * localDirection.getZ());
 		if (localDirection.getX() < 0)
 			std::swap(localEntryPoint, localExitPoint);
-	} // end of "aChRMatData.m_minAxis == 0"
-	else if (aChRMatData.m_minAxis == 1) {
+	} // end of "theOptics.m_minAxis == 0"
+	else if (theOptics.m_minAxis == 1) {
 		if (localDirection.getY() == 0.) {
 			if (m_verboseLevel > 0)
 				PrintJustWarningExplanations(12);
 			return false;
 		}
-		intensity = (-aChRMatData.m_halfThickness + localMiddlePoint.getY() - localPrePoint.getY()) / localDirection.getY();
+		intensity = (-theOptics.m_halfThickness + localMiddlePoint.getY() - localPrePoint.getY()) / localDirection.getY();
 		localEntryPoint.set(localPrePoint.getX() + intensity * localDirection.getX(),
-			-aChRMatData.m_halfThickness + localMiddlePoint.getY(),
+			-theOptics.m_halfThickness + localMiddlePoint.getY(),
 			localPrePoint.getZ() + intensity * localDirection.getZ());
-		intensity = (aChRMatData.m_halfThickness + localMiddlePoint.getY() - localPrePoint.getY()) / localDirection.getY();
+		intensity = (theOptics.m_halfThickness + localMiddlePoint.getY() - localPrePoint.getY()) / localDirection.getY();
 		localExitPoint.set(localPrePoint.getX() + intensity * localDirection.getX(),
-			aChRMatData.m_halfThickness + localMiddlePoint.getY(),
+			theOptics.m_halfThickness + localMiddlePoint.getY(),
 			localPrePoint.getZ() + intensity * localDirection.getZ());
 		if (localDirection.getY() < 0)
 			std::swap(localEntryPoint, localExitPoint);
-	} // end of "aChRMatData.m_minAxis == 1"
-	else /*aChRMatData.m_minAxis == 2*/ {
+	} // end of "theOptics.m_minAxis == 1"
+	else /*theOptics.m_minAxis == 2*/ {
 		if (localDirection.getZ() == 0.) {
 			if (m_verboseLevel > 0)
 				PrintJustWarningExplanations(13);
 			return false;
 		}
-		intensity = (-aChRMatData.m_halfThickness + localMiddlePoint.getZ() - localPrePoint.getZ()) / localDirection.getZ();
+		intensity = (-theOptics.m_halfThickness + localMiddlePoint.getZ() - localPrePoint.getZ()) / localDirection.getZ();
 		localEntryPoint.set(localPrePoint.getX() + intensity * localDirection.getX(),
 			localPrePoint.getY() + intensity * localDirection.getY(),
-			-aChRMatData.m_halfThickness + localMiddlePoint.getZ());
-		intensity = (aChRMatData.m_halfThickness + localMiddlePoint.getZ() - localPrePoint.getZ()) / localDirection.getZ();
+			-theOptics.m_halfThickness + localMiddlePoint.getZ());
+		intensity = (theOptics.m_halfThickness + localMiddlePoint.getZ() - localPrePoint.getZ()) / localDirection.getZ();
 		localExitPoint.set(localPrePoint.getX() + intensity * localDirection.getX(),
 			localPrePoint.getY() + intensity * localDirection.getY(),
-			aChRMatData.m_halfThickness + localMiddlePoint.getZ());
+			theOptics.m_halfThickness + localMiddlePoint.getZ());
 		if (localDirection.getZ() < 0)
 			std::swap(localEntryPoint, localExitPoint);
-	} // end of "aChRMatData.m_minAxis == 2"
+	} // end of "theOptics.m_minAxis == 2"
 	return true;
 }
 
@@ -748,14 +668,14 @@ G4double G4ThinTargetChR_Model::CalculateGaussSigmaDistance(
 		const G4ThreeVector& localEntryPoint,
 		const G4ThreeVector& localExitPoint,
 		const G4ThreeVector& photonDirection,
-		const G4CherenkovMatData& matData) const {
+		const G4ChRResolvedOptics& theOptics) const {
 	
 	G4double neededResult;
-	if (matData.m_minAxis == 0) {
+	if (theOptics.m_minAxis == 0) {
 		if (photonDirection.getX() == 0.)
 			return DBL_MAX;
-		// 2 * matData.m_halfThickness == localExitPoint.getX() - localEntryPoint.getX()
-		G4double intensity = 2 * matData.m_halfThickness / photonDirection.getX();
+		// 2 * theOptics.m_halfThickness == localExitPoint.getX() - localEntryPoint.getX()
+		G4double intensity = 2 * theOptics.m_halfThickness / photonDirection.getX();
 		G4ThreeVector exitPhotonPoint =
 			G4ThreeVector{
 				localExitPoint.getX(),
@@ -763,11 +683,11 @@ G4double G4ThinTargetChR_Model::CalculateGaussSigmaDistance(
 				localEntryPoint.getZ() + intensity * photonDirection.getZ() };
 		neededResult = (localExitPoint - exitPhotonPoint).mag();
 	}
-	else if (matData.m_minAxis == 1) {
+	else if (theOptics.m_minAxis == 1) {
 		if (photonDirection.getY() == 0.)
 			return DBL_MAX;
-		// 2 * matData.m_halfThickness == localExitPoint.getY() - localEntryPoint.getY()
-		G4double intensity = 2 * matData.m_halfThickness / photonDirection.getY();
+		// 2 * theOptics.m_halfThickness == localExitPoint.getY() - localEntryPoint.getY()
+		G4double intensity = 2 * theOptics.m_halfThickness / photonDirection.getY();
 		G4ThreeVector exitPhotonPoint =
 			G4ThreeVector{
 				localEntryPoint.getX() + intensity * photonDirection.getX(),
@@ -778,8 +698,8 @@ G4double G4ThinTargetChR_Model::CalculateGaussSigmaDistance(
 	else /*for tubs and box z-coordinate it's the same code*/ {
 		if (photonDirection.getZ() == 0.)
 			return DBL_MAX;
-		// 2 * matData.m_halfThickness == localExitPoint.getZ() - localEntryPoint.getZ()
-		G4double intensity = 2 * matData.m_halfThickness / photonDirection.getZ();
+		// 2 * theOptics.m_halfThickness == localExitPoint.getZ() - localEntryPoint.getZ()
+		G4double intensity = 2 * theOptics.m_halfThickness / photonDirection.getZ();
 		G4ThreeVector exitPhotonPoint =
 			G4ThreeVector{
 				localEntryPoint.getX() + intensity * photonDirection.getX(),
@@ -797,6 +717,21 @@ G4double G4ThinTargetChR_Model::CalculateGaussSigmaDistance(
 	return neededResult;
 }
 
+G4double G4ThinTargetChR_Model::CalculateConeMargin(
+		const G4ThreeVector& localEntryPoint,
+		const G4ThreeVector& localExitPoint,
+		const G4ThreeVector& localAxis,
+		const size_t i,
+		const G4double theCosAngle,
+		const G4ChRResolvedOptics& theOptics) const {
+	// gaussSigma of PostStepModelDoIt for a photon going along the cone axis
+	const G4double neededDistance = CalculateGaussSigmaDistance(localEntryPoint, localExitPoint, localAxis, theOptics);
+	if (neededDistance == DBL_MAX)
+		return 0.;
+	const G4double waveLng = 1.239841984e-6 * m * eV / m_photonBatch.m_energy[i];
+	return o_noOfMarginSigmas * 0.42466 * waveLng * theCosAngle / (m_photonBatch.m_RIndex[i] * neededDistance);
+}
+
 void G4ThinTargetChR_Model::SetBoxPhysicsTableParameters(G4CherenkovMatData& matData, const G4ThreeVector& halfThickness) const {
 	G4bool singleMinimal = true;
 	G4double minSize = halfThickness.getX();
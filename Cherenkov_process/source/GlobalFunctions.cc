@@ -11,6 +11,11 @@
 #include "G4AffineTransform.hh"
 #include "G4PhysicalVolumeStore.hh"
 #include "G4LogicalVolume.hh"
+#include "G4Threading.hh"
+#include "G4TaskGroup.hh"
+#include "G4ThreadPool.hh"
+#include "PTL/TaskRunManager.hh"
+#include "PTL/ThreadPool.hh"
 
 // Affine matrix is used like a homogenous in CGI, just without the projection part for the rasterization
 G4AffineTransform GetLocalToGlobalTransformOfPhysicalVolume(const G4VPhysicalVolume* aPhysicalVolume) {
@@ -48,4 +53,18 @@ G4AffineTransform GetLocalToGlobalTransformOfPhysicalVolume(const G4VPhysicalVol
 
 G4AffineTransform GetGlobalToLocalTransformOfPhysicalVolume(const G4VPhysicalVolume* aPhysicalVolume) {
 	return GetLocalToGlobalTransformOfPhysicalVolume(aPhysicalVolume).Inverse();
+}
+
+void G4ExecuteInTaskPool(const size_t noOfTasks, const std::function<void(const size_t)>& aTask) {
+	PTL::TaskRunManager* taskRunManager = PTL::TaskRunManager::GetInstance();
+	PTL::ThreadPool* thrPool = taskRunManager ? taskRunManager->GetThreadPool() : nullptr;
+	if (noOfTasks < 2 || !thrPool || thrPool->size() < 2 || G4Threading::IsWorkerThread()) {
+		for (size_t i = 0; i < noOfTasks; i++)
+			aTask(i);
+		return;
+	}
+	PTL::TaskGroup<void> taskGroup{ thrPool };
+	for (size_t i = 0; i < noOfTasks; i++)
+		taskGroup.exec([&aTask, i]() { aTask(i); });
+	taskGroup.wait();
 }
\ No newline at end of file